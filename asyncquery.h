@@ -0,0 +1,361 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   AsyncQuery.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 4:30 PM
+ */
+
+#ifndef ASYNCQUERY_H
+#define	ASYNCQUERY_H
+
+/*
+ * Optional C++20 coroutine layer. The header is empty unless it is compiled
+ * as C++20 with <coroutine> available, the library itself stays C++11.
+ */
+#if defined(__has_include)
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+#define SQLPP_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef SQLPP_HAS_COROUTINES
+#include "database.hpp"
+#include "typedquery.h"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace SQLPP
+{
+    /**
+     * @brief Posts a function to the event loop of the caller.
+     *
+     * An empty Scheduler resumes coroutines directly on the worker thread.
+     */
+    using Scheduler = std::function<void(std::function<void()>)>;
+
+    /* Runs work on the worker thread of a connection, then resumes the coroutine */
+    template <typename T>
+    class _WorkAwaitable
+    {
+    public:
+        _WorkAwaitable(Database &db, const Scheduler &scheduler, std::function<T(Database &)> work)
+        : db(db), scheduler(scheduler), work(std::move(work))
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            // The task owns a copy of the scheduler : the coroutine may resume and
+            // destroy this awaitable before the scheduler call returns
+            db.submit([this, handle, scheduler = scheduler](Database & d) {
+                try {
+                    result.emplace(work(d));
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                // Nothing of this awaitable may be touched once the coroutine runs again
+                if (scheduler) {
+                    scheduler([handle]() {
+                        handle.resume();
+                    });
+                } else {
+                    handle.resume();
+                }
+            });
+        }
+
+        T await_resume()
+        {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return std::move(*result);
+        }
+
+    private:
+        Database &db;
+        Scheduler scheduler;
+        std::function<T(Database &)> work;
+        std::optional<T> result;
+        std::exception_ptr error;
+    };
+
+    /**
+     * @brief Rows of a query fetched in batches on the worker thread.
+     *
+     * co_await next() returns the next row, or std::nullopt after the last
+     * one. The coroutine is only suspended when the current batch is used
+     * up. The query keeps its read transaction open until the last row has
+     * been fetched or the object is destroyed; a stream dropped before its
+     * end hands its statement back to the worker thread to be reset there.
+     * @tparam Row std::tuple of the column types, as for TypedQuery
+     */
+    template <typename Row>
+    class AsyncRows
+    {
+    public:
+        AsyncRows(Database &db, const Scheduler &scheduler, std::function<TypedQuery<Row> *(Database &) > open,
+                  size_t batchSize)
+        : db(&db), scheduler(scheduler), state(std::make_shared<State>())
+        {
+            state->open = std::move(open);
+            state->batchSize = batchSize > 0 ? batchSize : 1;
+        }
+
+        AsyncRows(AsyncRows &&orig) = default;
+        AsyncRows(const AsyncRows &orig) = delete;
+
+        ~AsyncRows()
+        {
+            release();
+        }
+
+        AsyncRows & operator=(AsyncRows &&orig)
+        {
+            if (this != &orig) {
+                release();
+                db = orig.db;
+                scheduler = std::move(orig.scheduler);
+                state = std::move(orig.state);
+            }
+            return *this;
+        }
+
+        AsyncRows & operator=(const AsyncRows &orig) = delete;
+
+        class NextAwaitable
+        {
+        public:
+            explicit NextAwaitable(AsyncRows &rows) : rows(rows)
+            {
+            }
+
+            bool await_ready() const noexcept
+            {
+                return rows.state->position < rows.state->batch.size() || rows.state->done;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                fetch.emplace(*rows.db, rows.scheduler, [state = rows.state](Database & d) {
+                    state->fill(d);
+                    return true;
+                });
+                fetch->await_suspend(handle);
+            }
+
+            std::optional<Row> await_resume()
+            {
+                if (fetch) {
+                    fetch->await_resume();
+                }
+                State &s = *rows.state;
+                if (s.position < s.batch.size()) {
+                    return std::move(s.batch[s.position++]);
+                }
+                return std::nullopt;
+            }
+
+        private:
+            AsyncRows &rows;
+            std::optional<_WorkAwaitable<bool> > fetch;
+        };
+
+        /**
+         * @brief Get the next row
+         * @return Awaitable of std::optional<Row>, empty after the last row
+         * @throw SQLiteException (when awaited) on error
+         */
+        NextAwaitable next()
+        {
+            return NextAwaitable(*this);
+        }
+
+    private:
+        struct State
+        {
+            std::function<TypedQuery<Row> *(Database &) > open;
+            std::unique_ptr<TypedQuery<Row> > query;
+            typename TypedQuery<Row>::iterator it;
+            size_t batchSize = 0;
+            std::vector<Row> batch;
+            size_t position = 0;
+            bool done = false;
+
+            /* Worker thread only */
+            void fill(Database &d)
+            {
+                batch.clear();
+                position = 0;
+                if (!query) {
+                    query.reset(open(d));
+                    it = query->begin();
+                }
+                while (batch.size() < batchSize && it != query->end()) {
+                    batch.push_back(*it);
+                    ++it;
+                }
+                if (it == query->end()) {
+                    done = true;
+                    query.reset();
+                }
+            }
+        };
+
+        /* The statement of an unfinished query is only touched by the worker thread */
+        void release() noexcept
+        {
+            if (state && state->query) {
+                try {
+                    db->submit([state = std::move(state)](Database &) mutable {
+                        state->it = typename TypedQuery<Row>::iterator();
+                        state->query.reset();
+                        state.reset();
+                    });
+                } catch (...) {
+                    // The connection is closing and takes the statement down with it
+                }
+            }
+            state.reset();
+        }
+
+        Database *db;
+        Scheduler scheduler;
+        std::shared_ptr<State> state;
+    };
+
+    /**
+     * @brief Coroutine front end of a Database.
+     *
+     * Queries are stepped on the worker thread of the connection (see
+     * Database::submit), the awaiting coroutine is resumed through the
+     * scheduler, so a slow query costs a suspended frame instead of a
+     * blocked thread.
+     *
+     * @code
+     * SQLPP::AsyncDatabase adb(db, [&loop](std::function<void()> f) { loop.post(f); });
+     * auto users = co_await adb.query<std::tuple<int64_t, std::string> >("select id, name from users where score > ?", 10);
+     * auto rows = adb.rows<std::tuple<int64_t> >("select id from events");
+     * while (auto row = co_await rows.next()) { ... }
+     * @endcode
+     */
+    class AsyncDatabase
+    {
+    public:
+        /**
+         * @brief Construct a new Async Database object
+         * @param db The connection, it must outlive this object and the pending queries
+         * @param scheduler Resumes the coroutines on the caller's event loop
+         */
+        explicit AsyncDatabase(Database &db, Scheduler scheduler = Scheduler())
+        : db(db), scheduler(std::move(scheduler))
+        {
+        }
+
+        /**
+         * @brief Run a query and collect all its rows
+         * @param sql The SQL query string
+         * @param values Values of the parameters 1..N, copied until the query has run
+         * @return Awaitable of std::vector<Row>
+         * @throw SQLiteException (when awaited) on error
+         */
+        template <typename Row, typename... Values>
+        _WorkAwaitable<std::vector<Row> > query(const std::string &sql, Values &&... values)
+        {
+            auto bound = std::make_shared<std::tuple<typename _AsyncValue<typename std::decay<Values>::type>::type...> >(
+                    std::forward<Values>(values)...);
+            return _WorkAwaitable<std::vector<Row> >(db, scheduler, [sql, bound](Database & d) {
+                TypedQuery<Row> q(&d, sql);
+                std::apply([&q](const auto &... v) {
+                    q.bind(v...);
+                }, *bound);
+                return q.fetchAll();
+            });
+        }
+
+        /**
+         * @brief Run a function on the worker thread of the connection
+         * @param function Callable taking a Database &, returning a value
+         * @return Awaitable of the function result
+         */
+        template <typename Function>
+        auto submit(Function function) -> _WorkAwaitable<decltype(function(std::declval<Database &>()))>
+        {
+            return _WorkAwaitable<decltype(function(std::declval<Database &>()))>(db, scheduler, std::move(function));
+        }
+
+        /**
+         * @brief Iterate over the rows of a query, fetched batchSize at a time
+         * @param sql The SQL query string
+         * @param values Values of the parameters 1..N, copied until the query has run
+         * @return AsyncRows<Row> The row stream, prepared on the first next()
+         */
+        template <typename Row, typename... Values>
+        AsyncRows<Row> rows(const std::string &sql, Values &&... values)
+        {
+            return rowsInBatches<Row>(256, sql, std::forward<Values>(values)...);
+        }
+
+        /**
+         * @brief Same as rows() with an explicit number of rows per batch
+         * @param batchSize Rows fetched by each trip to the worker thread
+         * @param sql The SQL query string
+         * @param values Values of the parameters 1..N, copied until the query has run
+         * @return AsyncRows<Row> The row stream, prepared on the first next()
+         */
+        template <typename Row, typename... Values>
+        AsyncRows<Row> rowsInBatches(size_t batchSize, const std::string &sql, Values &&... values)
+        {
+            auto bound = std::make_shared<std::tuple<typename _AsyncValue<typename std::decay<Values>::type>::type...> >(
+                    std::forward<Values>(values)...);
+            return AsyncRows<Row>(db, scheduler, [sql, bound](Database & d) {
+                std::unique_ptr<TypedQuery<Row> > q(new TypedQuery<Row>(&d, sql));
+                std::apply([&q](const auto &... v) {
+                    q->bind(v...);
+                }, *bound);
+                return q.release();
+            }, batchSize);
+        }
+
+    private:
+        Database &db;
+        Scheduler scheduler;
+    };
+}
+#endif	/* SQLPP_HAS_COROUTINES */
+#endif	/* ASYNCQUERY_H */
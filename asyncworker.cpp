@@ -0,0 +1,185 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   AsyncWorker.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 3:50 PM
+ */
+
+#include "asyncworker.h"
+#include "database.hpp"
+#include <sqlite3.h>
+
+namespace SQLPP
+{
+    using locker = std::lock_guard<std::mutex>;
+
+    void _AsyncStatement::execute(Database &db)
+    {
+        try {
+            changes = db.executeBound(sql, bind);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    void _AsyncStatement::complete()
+    {
+        if (error) {
+            promise.set_exception(std::move(error));
+        } else {
+            promise.set_value(changes);
+        }
+    }
+
+    void _AsyncStatement::fail(std::exception_ptr batchError)
+    {
+        // A statement that failed by itself reports its own error
+        promise.set_exception(error ? std::move(error) : batchError);
+    }
+
+    _AsyncWorker::_AsyncWorker(Database *db) : db(db), thread(&_AsyncWorker::run, this)
+    {
+    }
+
+    _AsyncWorker::~_AsyncWorker()
+    {
+        {
+            locker l(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_one();
+        thread.join();
+    }
+
+    void _AsyncWorker::push(_AsyncTask *task)
+    {
+        queue.push(task);
+        pending.fetch_add(1);
+        if (sleeping.load()) {
+            locker l(mutex);
+            wakeUp.notify_one();
+        }
+    }
+
+    void _AsyncWorker::run()
+    {
+        std::vector<_AsyncTask *> tasks;
+        while (true) {
+            _AsyncTask *task;
+            while ((task = queue.pop()) != nullptr) {
+                tasks.push_back(task);
+            }
+            if (!tasks.empty()) {
+                pending.fetch_sub(tasks.size());
+                runTasks(tasks);
+                tasks.clear();
+                continue;
+            }
+            if (pending.load() != 0) {
+                // A producer is in the middle of push()
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> l(mutex);
+            if (stopping) {
+                break;
+            }
+            sleeping = true;
+            wakeUp.wait(l, [this]() {
+                return pending.load() != 0 || stopping;
+            });
+            sleeping = false;
+        }
+    }
+
+    void _AsyncWorker::runTasks(std::vector<_AsyncTask *> &tasks)
+    {
+        size_t i = 0;
+        while (i < tasks.size()) {
+            size_t end = i;
+            while (end < tasks.size() && tasks[end]->batchable()) {
+                end++;
+            }
+            if (end - i > 1) {
+                runBatch(tasks.data() + i, tasks.data() + end);
+                i = end;
+                continue;
+            }
+            tasks[i]->execute(*db);
+            tasks[i]->complete();
+            delete tasks[i];
+            i++;
+        }
+    }
+
+    void _AsyncWorker::runBatch(_AsyncTask **first, _AsyncTask **last)
+    {
+        // No other thread may use the connection while the batch transaction is open
+        HandleLock connectionLock(db->d->mutex);
+        if (sqlite3_get_autocommit(db->getSqltite3db()) == 0) {
+            // The transaction belongs to someone else, the statements run in it one by one
+            for (_AsyncTask **task = first; task != last; task++) {
+                (*task)->execute(*db);
+                (*task)->complete();
+                delete *task;
+            }
+            return;
+        }
+        try {
+            db->begin();
+            // One transaction for the run of statements, a savepoint isolates each of them
+            for (_AsyncTask **task = first; task != last; task++) {
+                db->exec("savepoint sqlpp_async");
+                (*task)->execute(*db);
+                if ((*task)->failed()) {
+                    db->exec("rollback to sqlpp_async");
+                }
+                db->exec("release sqlpp_async");
+            }
+            db->commit();
+        }
+        catch (...) {
+            std::exception_ptr error = std::current_exception();
+            if (!sqlite3_get_autocommit(db->getSqltite3db())) {
+                try {
+                    db->rollback();
+                }
+                catch (...) {
+                    // Keep the original error
+                }
+            }
+            for (_AsyncTask **task = first; task != last; task++) {
+                (*task)->fail(error);
+                delete *task;
+            }
+            return;
+        }
+        for (_AsyncTask **task = first; task != last; task++) {
+            (*task)->complete();
+            delete *task;
+        }
+    }
+}
@@ -0,0 +1,193 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   AsyncWorker.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 3:50 PM
+ */
+
+#ifndef ASYNCWORKER_H
+#define	ASYNCWORKER_H
+#include "mpscqueue.h"
+#include <sqlite3.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SQLPP
+{
+    class Database;
+
+    /* Work queued to the worker thread of a connection */
+    class _AsyncTask : public _MpscNode
+    {
+    public:
+        virtual ~_AsyncTask()
+        {
+        }
+
+        /* Statements may share a write batch with their neighbours */
+        virtual bool batchable() const
+        {
+            return false;
+        }
+
+        /* Run the task, errors are kept for complete() */
+        virtual void execute(Database &db) = 0;
+
+        /* Publish the outcome of execute() */
+        virtual void complete()
+        {
+        }
+
+        /* Publish error instead of the outcome of execute() */
+        virtual void fail(std::exception_ptr)
+        {
+        }
+
+        virtual bool failed() const
+        {
+            return false;
+        }
+    };
+
+    /* Type stored by executeAsync() for a bound value, C strings are copied */
+    template <typename T>
+    struct _AsyncValue
+    {
+        typedef T type;
+    };
+
+    template <>
+    struct _AsyncValue<const char *>
+    {
+        typedef std::string type;
+    };
+
+    template <>
+    struct _AsyncValue<char *>
+    {
+        typedef std::string type;
+    };
+
+    /* Database::submit() task */
+    template <typename Result>
+    class _AsyncCall : public _AsyncTask
+    {
+    public:
+        template <typename Function>
+        explicit _AsyncCall(Function &&function) : task(std::forward<Function>(function))
+        {
+        }
+
+        std::future<Result> future()
+        {
+            return task.get_future();
+        }
+
+        void execute(Database &db) override
+        {
+            task(db);
+        }
+
+    private:
+        std::packaged_task<Result(Database &)> task;
+    };
+
+    /* Database::executeAsync() task */
+    class _AsyncStatement : public _AsyncTask
+    {
+    public:
+        _AsyncStatement(const std::string &sql, std::function<void(sqlite3_stmt *) > &&bind)
+        : sql(sql), bind(std::move(bind))
+        {
+        }
+
+        std::future<int> future()
+        {
+            return promise.get_future();
+        }
+
+        bool batchable() const override
+        {
+            return true;
+        }
+
+        void execute(Database &db) override;
+        void complete() override;
+        void fail(std::exception_ptr error) override;
+
+        bool failed() const override
+        {
+            return error != nullptr;
+        }
+
+    private:
+        std::string sql;
+        std::function<void(sqlite3_stmt *) > bind;
+        std::promise<int> promise;
+        int changes = 0;
+        std::exception_ptr error;
+    };
+
+    /*
+     * Worker thread of a connection. Tasks are pushed on a lock-free queue,
+     * the producers only take the mutex to wake up a sleeping worker.
+     */
+    class _AsyncWorker
+    {
+    public:
+        explicit _AsyncWorker(Database *db);
+        /* Run the queued tasks and join the thread */
+        ~_AsyncWorker();
+
+        _AsyncWorker(const _AsyncWorker &orig) = delete;
+        _AsyncWorker & operator=(const _AsyncWorker &orig) = delete;
+
+        void push(_AsyncTask *task);
+
+    private:
+        void run();
+        void runTasks(std::vector<_AsyncTask *> &tasks);
+        void runBatch(_AsyncTask **first, _AsyncTask **last);
+
+        Database *db;
+        MpscQueue<_AsyncTask> queue;
+        std::atomic<size_t> pending{0};
+        std::atomic<bool> sleeping{false};
+        std::atomic<bool> stopping{false};
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::thread thread;
+    };
+}
+#endif	/* ASYNCWORKER_H */
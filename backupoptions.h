@@ -0,0 +1,96 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   BackupOptions.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 8:20 PM
+ */
+
+#ifndef BACKUPOPTIONS_H
+#define	BACKUPOPTIONS_H
+#include <functional>
+#include <string>
+
+namespace SQLPP
+{
+    /**
+     * @brief State of a running backup, given to BackupOptions::progress.
+     */
+    struct BackupProgress
+    {
+        /** Pages of the source database (sqlite3_backup_pagecount) */
+        int pageCount = 0;
+        /** Pages left to copy (sqlite3_backup_remaining) */
+        int remaining = 0;
+        /** Number of times the copy started over because the source changed */
+        int restarts = 0;
+
+        double fraction() const
+        {
+            return pageCount > 0 ? 1.0 - static_cast<double> (remaining) / pageCount : 0;
+        }
+    };
+
+    /**
+     * @brief Outcome of Database::backupTo.
+     */
+    struct BackupResult
+    {
+        /** false if the progress callback cancelled the backup */
+        bool completed = false;
+        /** Pages of the source database when the copy ended */
+        int pageCount = 0;
+        /** Number of sqlite3_backup_step calls */
+        int steps = 0;
+        /** Number of times the copy started over because the source changed */
+        int restarts = 0;
+        /** Wall time, including the sleeps between steps */
+        double seconds = 0;
+    };
+
+    /**
+     * @brief Settings of Database::backupTo.
+     *
+     * The source is only locked while a step copies its pages, the
+     * connection serves other requests during the sleeps. A write made
+     * through another connection makes SQLite start the copy over; writes
+     * made through the source connection itself are copied as they happen.
+     */
+    struct BackupOptions
+    {
+        /** Pages copied by each step, negative copies everything in one step */
+        int pagesPerStep = 256;
+        /** Sleep between two steps, and before retrying when a database is busy */
+        int sleepMillis = 10;
+        /** Give up with an exception after this many restarts, 0 never gives up */
+        int maxRestarts = 0;
+        /** Schema copied from the source */
+        std::string sourceSchema = "main";
+        /** Schema replaced in the destination */
+        std::string destSchema = "main";
+        /** Called after every step, return false to cancel the backup */
+        std::function<bool(const BackupProgress &)> progress;
+    };
+}
+#endif	/* BACKUPOPTIONS_H */
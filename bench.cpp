@@ -0,0 +1,696 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   bench.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 11:40 AM
+ */
+
+/*
+ * Every scenario runs through sqlpp and through the equivalent raw sqlite3_*
+ * code, on two identical in-memory databases. Allocations are counted by
+ * interposing malloc, so they include the allocations made by SQLite itself.
+ *
+ * usage : sqlpp_bench [rows]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <sqlite3.h>
+#include "database.hpp"
+#include "preparedstatement.h"
+#include "sqliteexception.h"
+#include "cursor.h"
+#include "rowmapping.h"
+#include "typedquery.h"
+
+#if defined(__GLIBC__)
+#define SQLPP_BENCH_COUNT_ALLOCATIONS 1
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+namespace
+{
+    std::atomic<uint64_t> allocations(0);
+}
+
+extern "C" void *malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+using namespace std;
+
+struct BenchRow
+{
+    int64_t id;
+    string s;
+    double d;
+};
+SQLPP_FIELDS(BenchRow, id, s, d)
+
+namespace
+{
+    int ROWS = 1000000;
+    const int BLOB_SIZE = 4096;
+
+    /* Keeps the optimizer from dropping the benchmarked reads */
+    volatile int64_t sink;
+
+    uint64_t allocationCount()
+    {
+#ifdef SQLPP_BENCH_COUNT_ALLOCATIONS
+        return allocations.load(memory_order_relaxed);
+#else
+        return 0;
+#endif
+    }
+
+    /*
+     * Run a scenario, it returns the number of operations it performed
+     */
+    void run(const char *name, const function<int64_t()> &scenario)
+    {
+        uint64_t allocs = allocationCount();
+        auto start = chrono::steady_clock::now();
+        int64_t ops = scenario();
+        auto end = chrono::steady_clock::now();
+        allocs = allocationCount() - allocs;
+        double ns = chrono::duration<double, nano>(end - start).count();
+        if (ops <= 0) {
+            ops = 1;
+        }
+#ifdef SQLPP_BENCH_COUNT_ALLOCATIONS
+        printf("%-44s %10.1f ns/op %8.2f allocs/op\n", name, ns / ops, static_cast<double> (allocs) / ops);
+#else
+        printf("%-44s %10.1f ns/op\n", name, ns / ops);
+#endif
+    }
+
+    const char *SCHEMA =
+            "create table bench (id integer primary key, i int, d real, s text, b blob);"
+            "create table sink (i int, d real);"
+            "create table blobs (id integer primary key, b blob);"
+            "create table params (a int, b int, c int, d int);";
+
+    string fillSql()
+    {
+        return "with recursive c(x) as (select 1 union all select x + 1 from c where x < " + to_string(ROWS) + ") "
+                "insert into bench select x, x, x * 0.5, 'row ' || x, randomblob(32) from c";
+    }
+
+    void fill(SQLPP::Database &db)
+    {
+        db.exec(SCHEMA);
+        db.exec(fillSql());
+    }
+
+    void fill(sqlite3 *db)
+    {
+        sqlite3_exec(db, SCHEMA, nullptr, nullptr, nullptr);
+        sqlite3_exec(db, fillSql().c_str(), nullptr, nullptr, nullptr);
+    }
+
+    sqlite3_stmt *rawPrepare(sqlite3 *db, const char *sql)
+    {
+        sqlite3_stmt *stmt = nullptr;
+        if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            throw SQLPP::SQLiteException(sqlite3_errcode(db), sqlite3_errmsg(db));
+        }
+        return stmt;
+    }
+
+    /* ---------------------------------------------------------------- inserts */
+
+    int64_t insertAutocommit(SQLPP::Database &db, int count)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("insert into sink values (?, ?)");
+        for (int i = 0; i < count; i++) {
+            stmt.setInt(1, i);
+            stmt.setDouble(2, i * 0.5);
+            stmt.executeUpdate();
+        }
+        return count;
+    }
+
+    int64_t insertAutocommit(sqlite3 *db, int count)
+    {
+        sqlite3_stmt *stmt = rawPrepare(db, "insert into sink values (?, ?)");
+        for (int i = 0; i < count; i++) {
+            sqlite3_bind_int(stmt, 1, i);
+            sqlite3_bind_double(stmt, 2, i * 0.5);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        return count;
+    }
+
+    int64_t insertTransaction(SQLPP::Database &db)
+    {
+        db.begin();
+        insertAutocommit(db, ROWS);
+        db.commit();
+        return ROWS;
+    }
+
+    int64_t insertTransaction(sqlite3 *db)
+    {
+        sqlite3_exec(db, "begin", nullptr, nullptr, nullptr);
+        insertAutocommit(db, ROWS);
+        sqlite3_exec(db, "commit", nullptr, nullptr, nullptr);
+        return ROWS;
+    }
+
+    int64_t insertMany(SQLPP::Database &db)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("insert into sink values (?, ?)");
+        int i = 0;
+        SQLPP::BatchResult result = stmt.executeMany([&](SQLPP::PreparedStatement & s) {
+            if (i == ROWS) {
+                return false;
+            }
+            s.setInt(1, i);
+            s.setDouble(2, i * 0.5);
+            i++;
+            return true;
+        });
+        return result.rows;
+    }
+
+    /* ----------------------------------------------------------- point select */
+
+    int lookupKey(int k)
+    {
+        return 1 + (k * 7919) % ROWS;
+    }
+
+    int64_t pointSelect(SQLPP::Database &db)
+    {
+        const int lookups = ROWS / 4;
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("select i from bench where id = ?");
+        int64_t sum = 0;
+        for (int k = 0; k < lookups; k++) {
+            stmt.setInt(1, lookupKey(k));
+            SQLPP::Cursor c = stmt.execute();
+            if (c.next()) {
+                sum += c.getAsInt(0);
+            }
+            c.close();
+        }
+        sink = sum;
+        return lookups;
+    }
+
+    int64_t pointSelect(sqlite3 *db)
+    {
+        const int lookups = ROWS / 4;
+        sqlite3_stmt *stmt = rawPrepare(db, "select i from bench where id = ?");
+        int64_t sum = 0;
+        for (int k = 0; k < lookups; k++) {
+            sqlite3_bind_int(stmt, 1, lookupKey(k));
+            if (sqlite3_step(stmt) == SQLITE_ROW) {
+                sum += sqlite3_column_int(stmt, 0);
+            }
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        sink = sum;
+        return lookups;
+    }
+
+    /* -------------------------------------------------------------- full scan */
+
+    enum class Getter
+    {
+        Int, Long, Float, Double, String, Blob
+    };
+
+    const char *scanSql(Getter getter)
+    {
+        switch (getter) {
+        case Getter::Int: return "select i from bench";
+        case Getter::Long: return "select id from bench";
+        case Getter::Float:
+        case Getter::Double: return "select d from bench";
+        case Getter::String: return "select s from bench";
+        case Getter::Blob: return "select b from bench";
+        }
+        return nullptr;
+    }
+
+    int64_t scan(SQLPP::Database &db, Getter getter, SQLPP::HandlePolicy policy = SQLPP::HandlePolicy::ThreadSafe)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare(scanSql(getter));
+        stmt.setHandlePolicy(policy);
+        SQLPP::Cursor c = stmt.execute();
+        int64_t rows = 0;
+        double sum = 0;
+        while (c.next()) {
+            switch (getter) {
+            case Getter::Int: sum += c.getAsInt(0);
+                break;
+            case Getter::Long: sum += c.getAsLong(0);
+                break;
+            case Getter::Float: sum += c.getAsFloat(0);
+                break;
+            case Getter::Double: sum += c.getAsDouble(0);
+                break;
+            case Getter::String: sum += c.getAsString(0).size();
+                break;
+            case Getter::Blob: sum += c.getAsBlob(0).size();
+                break;
+            }
+            rows++;
+        }
+        sink = static_cast<int64_t> (sum);
+        return rows;
+    }
+
+    int64_t scan(sqlite3 *db, Getter getter)
+    {
+        sqlite3_stmt *stmt = rawPrepare(db, scanSql(getter));
+        int64_t rows = 0;
+        double sum = 0;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            switch (getter) {
+            case Getter::Int: sum += sqlite3_column_int(stmt, 0);
+                break;
+            case Getter::Long: sum += sqlite3_column_int64(stmt, 0);
+                break;
+            case Getter::Float: sum += static_cast<float> (sqlite3_column_double(stmt, 0));
+                break;
+            case Getter::Double: sum += sqlite3_column_double(stmt, 0);
+                break;
+            case Getter::String:
+                sqlite3_column_text(stmt, 0);
+                sum += sqlite3_column_bytes(stmt, 0);
+                break;
+            case Getter::Blob:
+                sqlite3_column_blob(stmt, 0);
+                sum += sqlite3_column_bytes(stmt, 0);
+                break;
+            }
+            rows++;
+        }
+        sqlite3_finalize(stmt);
+        sink = static_cast<int64_t> (sum);
+        return rows;
+    }
+
+    int64_t scanStringInto(SQLPP::Database &db, bool view)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("select s from bench");
+        SQLPP::Cursor c = stmt.execute();
+        int64_t rows = 0;
+        int64_t bytes = 0;
+        string buffer;
+        while (c.next()) {
+            if (view) {
+                bytes += c.getAsTextView(0).size;
+            } else {
+                c.getAsString(0, buffer);
+                bytes += buffer.size();
+            }
+            rows++;
+        }
+        sink = bytes;
+        return rows;
+    }
+
+    int64_t scanDoubleBatch(SQLPP::Database &db)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("select d from bench");
+        SQLPP::Cursor c = stmt.execute();
+        int64_t rows = 0;
+        double sum = 0;
+        vector<SQLPP::ColumnBatch> columns(1, SQLPP::ColumnBatch(0, SQLPP::ColumnType::Double));
+        size_t n;
+        while ((n = c.fetchBatch(4096, columns)) > 0) {
+            const double *values = columns[0].doubles().data();
+            for (size_t i = 0; i < n; i++) {
+                sum += values[i];
+            }
+            rows += n;
+        }
+        sink = static_cast<int64_t> (sum);
+        return rows;
+    }
+
+    int64_t scanRowsByName(SQLPP::Database &db)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("select id, s, d from bench");
+        SQLPP::Cursor c = stmt.execute();
+        int64_t rows = 0;
+        double sum = 0;
+        while (c.next()) {
+            sum += c.getAsLong("id") + c.getAsString("s").size() + c.getAsDouble("d");
+            rows++;
+        }
+        sink = static_cast<int64_t> (sum);
+        return rows;
+    }
+
+    int64_t scanRowsByRef(SQLPP::Database &db)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("select id, s, d from bench");
+        SQLPP::ColumnRef id = stmt.column("id");
+        SQLPP::ColumnRef s = stmt.column("s");
+        SQLPP::ColumnRef d = stmt.column("d");
+        SQLPP::Cursor c = stmt.execute();
+        int64_t rows = 0;
+        double sum = 0;
+        while (c.next()) {
+            sum += c.getAsLong(id) + c.getAsString(s).size() + c.getAsDouble(d);
+            rows++;
+        }
+        sink = static_cast<int64_t> (sum);
+        return rows;
+    }
+
+    int64_t scanRowsTyped(SQLPP::Database &db)
+    {
+        SQLPP::TypedQuery<tuple<int64_t, string, double> > query(&db, "select id, s, d from bench");
+        int64_t rows = 0;
+        double sum = 0;
+        for (const auto &row : query) {
+            sum += get<0>(row) + get<1>(row).size() + get<2>(row);
+            rows++;
+        }
+        sink = static_cast<int64_t> (sum);
+        return rows;
+    }
+
+    int64_t scanRowsMapped(SQLPP::Database &db)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("select id, s, d from bench");
+        SQLPP::Cursor c = stmt.execute();
+        BenchRow row;
+        int64_t rows = 0;
+        double sum = 0;
+        while (c.next()) {
+            c.read(row);
+            sum += row.id + row.s.size() + row.d;
+            rows++;
+        }
+        sink = static_cast<int64_t> (sum);
+        return rows;
+    }
+
+    /* ------------------------------------------------------- blob round trip */
+
+    int64_t blobRoundTrip(SQLPP::Database &db)
+    {
+        const int count = ROWS / 10;
+        vector<char> payload(BLOB_SIZE, 'x');
+        SQLPP::PreparedStatement insert(&db);
+        insert.prepare("insert or replace into blobs values (?, ?)");
+        SQLPP::PreparedStatement select(&db);
+        select.prepare("select b from blobs where id = ?");
+        int64_t bytes = 0;
+        for (int k = 0; k < count; k++) {
+            SQLPP::Blob blob(BLOB_SIZE, payload.data());
+            insert.setInt(1, k);
+            insert.setBlob(2, blob);
+            insert.executeUpdate();
+            select.setInt(1, k);
+            SQLPP::Cursor c = select.execute();
+            if (c.next()) {
+                bytes += c.getAsBlob(0).size();
+            }
+            c.close();
+        }
+        sink = bytes;
+        return count;
+    }
+
+    int64_t blobRoundTrip(sqlite3 *db)
+    {
+        const int count = ROWS / 10;
+        vector<char> payload(BLOB_SIZE, 'x');
+        vector<char> copy;
+        sqlite3_stmt *insert = rawPrepare(db, "insert or replace into blobs values (?, ?)");
+        sqlite3_stmt *select = rawPrepare(db, "select b from blobs where id = ?");
+        int64_t bytes = 0;
+        for (int k = 0; k < count; k++) {
+            sqlite3_bind_int(insert, 1, k);
+            sqlite3_bind_blob(insert, 2, payload.data(), BLOB_SIZE, SQLITE_STATIC);
+            sqlite3_step(insert);
+            sqlite3_reset(insert);
+            sqlite3_bind_int(select, 1, k);
+            if (sqlite3_step(select) == SQLITE_ROW) {
+                const char *data = static_cast<const char *> (sqlite3_column_blob(select, 0));
+                int size = sqlite3_column_bytes(select, 0);
+                copy.assign(data, data + size);
+                bytes += copy.size();
+            }
+            sqlite3_reset(select);
+        }
+        sqlite3_finalize(insert);
+        sqlite3_finalize(select);
+        sink = bytes;
+        return count;
+    }
+
+    /* ------------------------------------------------- named / indexed binds */
+
+    int64_t bindParams(SQLPP::Database &db, bool named)
+    {
+        SQLPP::PreparedStatement stmt(&db);
+        stmt.prepare("insert into params values (:a, :b, :c, :d)");
+        db.begin();
+        for (int i = 0; i < ROWS; i++) {
+            if (named) {
+                stmt.setInt(":a", i);
+                stmt.setInt(":b", i + 1);
+                stmt.setInt(":c", i + 2);
+                stmt.setInt(":d", i + 3);
+            } else {
+                stmt.setInt(1, i);
+                stmt.setInt(2, i + 1);
+                stmt.setInt(3, i + 2);
+                stmt.setInt(4, i + 3);
+            }
+            stmt.executeUpdate();
+        }
+        db.commit();
+        return ROWS;
+    }
+
+    int64_t bindParams(sqlite3 *db, bool named)
+    {
+        sqlite3_stmt *stmt = rawPrepare(db, "insert into params values (:a, :b, :c, :d)");
+        sqlite3_exec(db, "begin", nullptr, nullptr, nullptr);
+        for (int i = 0; i < ROWS; i++) {
+            if (named) {
+                sqlite3_bind_int(stmt, sqlite3_bind_parameter_index(stmt, ":a"), i);
+                sqlite3_bind_int(stmt, sqlite3_bind_parameter_index(stmt, ":b"), i + 1);
+                sqlite3_bind_int(stmt, sqlite3_bind_parameter_index(stmt, ":c"), i + 2);
+                sqlite3_bind_int(stmt, sqlite3_bind_parameter_index(stmt, ":d"), i + 3);
+            } else {
+                sqlite3_bind_int(stmt, 1, i);
+                sqlite3_bind_int(stmt, 2, i + 1);
+                sqlite3_bind_int(stmt, 3, i + 2);
+                sqlite3_bind_int(stmt, 4, i + 3);
+            }
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_exec(db, "commit", nullptr, nullptr, nullptr);
+        sqlite3_finalize(stmt);
+        return ROWS;
+    }
+}
+
+/*
+ *
+ */
+int main(int argc, char** argv)
+{
+    if (argc > 1) {
+        ROWS = atoi(argv[1]);
+        if (ROWS <= 0) {
+            fprintf(stderr, "usage : %s [rows]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    sqlite3 *raw = nullptr;
+    try {
+        SQLPP::Database db;
+        db.open(":memory:");
+        fill(db);
+        if (sqlite3_open(":memory:", &raw) != SQLITE_OK) {
+            throw SQLPP::SQLiteException(-1, "Cannot open raw database");
+        }
+        fill(raw);
+
+        const int single = ROWS / 10;
+        run("insert autocommit            sqlpp", [&]() {
+            return insertAutocommit(db, single);
+        });
+        run("insert autocommit            raw", [&]() {
+            return insertAutocommit(raw, single);
+        });
+        run("insert in transaction        sqlpp", [&]() {
+            return insertTransaction(db);
+        });
+        run("insert in transaction        sqlpp many", [&]() {
+            return insertMany(db);
+        });
+        run("insert in transaction        raw", [&]() {
+            return insertTransaction(raw);
+        });
+
+        run("point select                 sqlpp", [&]() {
+            return pointSelect(db);
+        });
+        run("point select                 raw", [&]() {
+            return pointSelect(raw);
+        });
+
+        const struct
+        {
+            const char *sqlpp;
+            const char *raw;
+            Getter getter;
+        } getters[] = {
+            {"scan getAsInt                sqlpp", "scan getAsInt                raw", Getter::Int},
+            {"scan getAsLong               sqlpp", "scan getAsLong               raw", Getter::Long},
+            {"scan getAsFloat              sqlpp", "scan getAsFloat              raw", Getter::Float},
+            {"scan getAsDouble             sqlpp", "scan getAsDouble             raw", Getter::Double},
+            {"scan getAsString             sqlpp", "scan getAsString             raw", Getter::String},
+            {"scan getAsBlob               sqlpp", "scan getAsBlob               raw", Getter::Blob},
+        };
+        for (const auto &g : getters) {
+            run(g.sqlpp, [&]() {
+                return scan(db, g.getter);
+            });
+            run(g.raw, [&]() {
+                return scan(raw, g.getter);
+            });
+        }
+        run("scan getAsInt                sqlpp 1-thread", [&]() {
+            return scan(db, Getter::Int, SQLPP::HandlePolicy::SingleThread);
+        });
+        run("scan getAsString             sqlpp buffer", [&]() {
+            return scanStringInto(db, false);
+        });
+        run("scan getAsString             sqlpp view", [&]() {
+            return scanStringInto(db, true);
+        });
+        run("scan getAsDouble             sqlpp batch", [&]() {
+            return scanDoubleBatch(db);
+        });
+        run("scan 3 columns               sqlpp by name", [&]() {
+            return scanRowsByName(db);
+        });
+        run("scan 3 columns               sqlpp by ref", [&]() {
+            return scanRowsByRef(db);
+        });
+        run("scan 3 columns               sqlpp typed", [&]() {
+            return scanRowsTyped(db);
+        });
+        run("scan 3 columns               sqlpp mapped", [&]() {
+            return scanRowsMapped(db);
+        });
+
+        run("blob round trip              sqlpp", [&]() {
+            return blobRoundTrip(db);
+        });
+        run("blob round trip              raw", [&]() {
+            return blobRoundTrip(raw);
+        });
+
+        run("bind 4 named params          sqlpp", [&]() {
+            return bindParams(db, true);
+        });
+        run("bind 4 named params          raw", [&]() {
+            return bindParams(raw, true);
+        });
+        run("bind 4 indexed params        sqlpp", [&]() {
+            return bindParams(db, false);
+        });
+        run("bind 4 indexed params        raw", [&]() {
+            return bindParams(raw, false);
+        });
+        sqlite3_close(raw);
+        raw = nullptr;
+
+        // Same lookups with both locking layers, then with neither
+        SQLPP::Database serialized;
+        serialized.open(":memory:", SQLPP::ThreadingMode::Serialized);
+        fill(serialized);
+        run("point select                 sqlpp FULLMUTEX", [&]() {
+            return pointSelect(serialized);
+        });
+
+        SQLPP::Database unlocked;
+        unlocked.setHandlePolicy(SQLPP::HandlePolicy::SingleThread);
+        unlocked.open(":memory:", SQLPP::ThreadingMode::MultiThread);
+        fill(unlocked);
+        run("point select                 sqlpp NOMUTEX 1-thread", [&]() {
+            return pointSelect(unlocked);
+        });
+    }
+    catch (std::exception &e) {
+        sqlite3_close(raw);
+        printf("%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -32,30 +32,46 @@
 #include <cstdlib>
 
 using namespace SQLPP;
-using locker = std::lock_guard<std::recursive_mutex>;
 
-Blob::Blob(int32_t size, const char * data) : d(new _BlobData)
+Blob::Blob(int32_t size, const char * data) : Blob(size, data, defaultMemoryResource())
+{
+}
+
+Blob::Blob(int32_t size, const char * data, MemoryResource * resource)
+: d(std::allocate_shared<_BlobData>(ResourceAllocator<_BlobData>(resource), resource))
 {
     
+    d->data = static_cast<char *>(resource->allocate(size));
     d->size = size;
-    d->data = static_cast<char *>(::malloc(size));
-    ::memcpy(d->data, data, size);
+    if (size > 0) {
+        ::memcpy(d->data, data, size);
+    }
+}
+
+Blob::Blob(Blob&& orig) : d(std::move(orig.d))
+{
 }
 
 Blob::~Blob()
 {
 }
 
+Blob& Blob::operator=(Blob&& orig)
+{
+    d = std::move(orig.d);
+    return *this;
+}
+
 
 int32_t Blob::size() const 
 {
-    
-    return d->size;
+    // A moved-from Blob is empty
+    return d ? d->size : 0;
 }
 
 const char * Blob::data() const 
 {
     
-    return d->data;
+    return d ? d->data : nullptr;
 }
 
@@ -34,35 +34,38 @@
 
 #include <memory>
 #include <stdint.h>
-#include <mutex>
 #include <cstdlib>
+#include "memoryresource.h"
 
 namespace SQLPP
 {
     class Blob;
+    class PreparedStatement;
     /* Easy way to create reference counted data */
     class _BlobData 
     {
         friend Blob;
     public:
-        _BlobData() : data(nullptr),size(0) {}
+        _BlobData(MemoryResource *resource) : size(0), data(nullptr), resource(resource) {}
         ~_BlobData() 
         {
-            ::free(data);
+            resource->deallocate(data, size);
         }
     private:
-        std::recursive_mutex mutex;
         int32_t size;
         char * data;
+        MemoryResource * resource;
     };
 
     /**
      * @brief A class representing a binary large object (BLOB) in SQLite.
      * 
      * This class manages reference-counted binary data and ensures proper memory management.
+     * The data is immutable once the Blob is built, so no locking is needed.
      */
     class Blob
     {
+        friend PreparedStatement;
     public:
         /**
          * @brief Construct a new Blob object
@@ -70,8 +73,28 @@ namespace SQLPP
          * @param data The binary data to store
          */
         Blob(int32_t size, const char * data);
+        /**
+         * @brief Construct a new Blob object whose data and bookkeeping come from resource
+         * @param size The size of the data in bytes
+         * @param data The binary data to store
+         * @param resource Source of memory, it must outlive the Blob and its copies
+         */
+        Blob(int32_t size, const char * data, MemoryResource * resource);
+        /**
+         * @brief Copy constructor, both objects share the same data
+         * @param orig Original object
+         */
+        Blob(const Blob& orig) = default;
+        /**
+         * @brief Move constructor, orig no longer refers to any data, it reports a size of 0
+         * @param orig Original object
+         */
+        Blob(Blob&& orig);
         
         virtual ~Blob();
+
+        Blob& operator=(const Blob& orig) = default;
+        Blob& operator=(Blob&& orig);
         
         /**
          * @brief Get the size of the blob data
@@ -0,0 +1,203 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   BlobStream.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 4:55 PM
+ */
+
+#include "blobstream.h"
+#include "sqliteexception.h"
+
+namespace SQLPP
+{
+    using locker = HandleLock;
+
+    namespace
+    {
+        /* A move leaves d null */
+        void checkMoved(const std::shared_ptr<_BlobStreamData> &d, const char *method)
+        {
+            if (!d) {
+                throw SQLiteException(-1, std::string("BlobStream::") + method + " - Stream was moved from");
+            }
+        }
+    }
+
+    BlobStream::BlobStream(Database *db) : d(std::make_shared<_BlobStreamData>())
+    {
+        d->db = db;
+        if (db != nullptr) {
+            d->mutex.setPolicy(db->handlePolicy());
+        }
+    }
+
+    BlobStream::BlobStream(BlobStream &&orig) : d(std::move(orig.d))
+    {
+    }
+
+    BlobStream::~BlobStream()
+    {
+    }
+
+    BlobStream & BlobStream::operator=(BlobStream &&orig)
+    {
+        d = std::move(orig.d);
+        return *this;
+    }
+
+    void BlobStream::open(const std::string &table, const std::string &column, int64_t rowid, bool writable,
+                          const std::string &schema)
+    {
+        checkMoved(d, "open");
+        locker l(d->mutex);
+        if (d->db == nullptr) {
+            throw SQLiteException(-1, "BlobStream::open - Database pointer is null");
+        }
+        if (d->blob != nullptr) {
+            sqlite3_blob_close(d->blob);
+            d->blob = nullptr;
+        }
+        int result = sqlite3_blob_open(d->db->getSqltite3db(), schema.c_str(), table.c_str(), column.c_str(), rowid,
+                                       writable ? 1 : 0, &d->blob);
+        if (result != SQLITE_OK) {
+            // A handle may be returned on error, it must still be closed
+            sqlite3_blob_close(d->blob);
+            d->blob = nullptr;
+            throw SQLiteException(result, d->db->errorMsg());
+        }
+        d->writable = writable;
+        d->size = sqlite3_blob_bytes(d->blob);
+        d->position = 0;
+    }
+
+    void BlobStream::reopen(int64_t rowid)
+    {
+        checkMoved(d, "reopen");
+        locker l(d->mutex);
+        check();
+        int result = sqlite3_blob_reopen(d->blob, rowid);
+        if (result != SQLITE_OK) {
+            throw SQLiteException(result, d->db->errorMsg());
+        }
+        d->size = sqlite3_blob_bytes(d->blob);
+        d->position = 0;
+    }
+
+    void BlobStream::close()
+    {
+        if (!d) {
+            return;
+        }
+        locker l(d->mutex);
+        sqlite3_blob_close(d->blob);
+        d->blob = nullptr;
+        d->size = 0;
+        d->position = 0;
+    }
+
+    bool BlobStream::isOpen() const
+    {
+        if (!d) {
+            return false;
+        }
+        locker l(d->mutex);
+        return d->blob != nullptr;
+    }
+
+    int BlobStream::size() const
+    {
+        if (!d) {
+            return 0;
+        }
+        locker l(d->mutex);
+        return d->size;
+    }
+
+    int BlobStream::tell() const
+    {
+        if (!d) {
+            return 0;
+        }
+        locker l(d->mutex);
+        return d->position;
+    }
+
+    void BlobStream::seek(int position)
+    {
+        checkMoved(d, "seek");
+        locker l(d->mutex);
+        check();
+        if (position < 0 || position > d->size) {
+            throw SQLiteException(-1, "BlobStream::seek - Position is out of the blob");
+        }
+        d->position = position;
+    }
+
+    size_t BlobStream::read(char *buffer, size_t count)
+    {
+        checkMoved(d, "read");
+        locker l(d->mutex);
+        check();
+        size_t available = static_cast<size_t> (d->size - d->position);
+        int n = static_cast<int> (count < available ? count : available);
+        if (n == 0) {
+            return 0;
+        }
+        int result = sqlite3_blob_read(d->blob, buffer, n, d->position);
+        if (result != SQLITE_OK) {
+            throw SQLiteException(result, d->db->errorMsg());
+        }
+        d->position += n;
+        return static_cast<size_t> (n);
+    }
+
+    void BlobStream::write(const char *data, size_t count)
+    {
+        checkMoved(d, "write");
+        locker l(d->mutex);
+        check();
+        if (!d->writable) {
+            throw SQLiteException(-1, "BlobStream::write - Blob is opened read-only");
+        }
+        if (count > static_cast<size_t> (d->size - d->position)) {
+            throw SQLiteException(-1, "BlobStream::write - Write goes past the end of the blob");
+        }
+        if (count == 0) {
+            return;
+        }
+        int result = sqlite3_blob_write(d->blob, data, static_cast<int> (count), d->position);
+        if (result != SQLITE_OK) {
+            throw SQLiteException(result, d->db->errorMsg());
+        }
+        d->position += static_cast<int> (count);
+    }
+
+    void BlobStream::check() const
+    {
+        if (d->blob == nullptr) {
+            throw SQLiteException(-1, "BlobStream - Blob is not open");
+        }
+    }
+}
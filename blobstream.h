@@ -0,0 +1,168 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   BlobStream.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 4:55 PM
+ */
+
+#ifndef BLOBSTREAM_H
+#define	BLOBSTREAM_H
+#include "database.hpp"
+#include "handlepolicy.h"
+#include <sqlite3.h>
+#include <stdint.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace SQLPP
+{
+    class BlobStream;
+
+    class _BlobStreamData
+    {
+        friend BlobStream;
+    public:
+        ~_BlobStreamData()
+        {
+            sqlite3_blob_close(blob);
+        }
+    private:
+        sqlite3_blob *blob = nullptr;
+        Database *db = nullptr;
+        int size = 0;
+        int position = 0;
+        bool writable = false;
+        HandleMutex mutex;
+    };
+
+    /**
+     * @brief Incremental access to one blob cell (sqlite3_blob_open).
+     *
+     * Reads and writes go through caller buffers of any size, so the value
+     * is never held in memory as a whole. A blob cannot change size through
+     * a stream : preallocate it with zeroblob (PreparedStatement::setZeroBlob
+     * or zeroblob(n) in SQL) then stream the data into it.
+     *
+     * @code
+     * insert.setZeroBlob(1, fileSize);
+     * insert.executeUpdate();
+     * SQLPP::BlobStream out(&db);
+     * out.open("attachments", "data", db.lastInsertRowId(), true);
+     * while ((n = fread(chunk, 1, sizeof (chunk), f)) > 0) out.write(chunk, n);
+     * @endcode
+     *
+     * Copies share the same handle, which is closed with the last copy. Any
+     * change to the row through SQL invalidates the stream : further calls
+     * throw SQLiteException with SQLITE_ABORT.
+     */
+    class BlobStream
+    {
+    public:
+        /**
+         * @brief Construct a new Blob Stream object
+         * @param db Pointer to the Database object
+         */
+        BlobStream(Database *db);
+        BlobStream(const BlobStream &orig) = default;
+        /**
+         * @brief Move constructor, orig no longer refers to a blob
+         *
+         * A moved-from stream reports isOpen() false and a size of 0, close()
+         * does nothing and the other calls throw SQLiteException.
+         * @param orig Original object
+         */
+        BlobStream(BlobStream &&orig);
+        virtual ~BlobStream();
+        BlobStream & operator=(const BlobStream &orig) = default;
+        BlobStream & operator=(BlobStream &&orig);
+
+        /**
+         * @brief Open the blob stored in a cell
+         * @param table Name of the table
+         * @param column Name of the blob column
+         * @param rowid Rowid of the row
+         * @param writable true to allow write()
+         * @param schema Name of the database ("main", "temp" or an attached name)
+         * @throw SQLiteException on error
+         */
+        void open(const std::string &table, const std::string &column, int64_t rowid, bool writable = false,
+                  const std::string &schema = "main");
+        /**
+         * @brief Move the stream to the same column of another row, faster than open()
+         * @param rowid Rowid of the row
+         * @throw SQLiteException on error
+         */
+        void reopen(int64_t rowid);
+        /**
+         * @brief Close the blob handle
+         */
+        void close();
+        /**
+         * @brief Check if a blob is open
+         * @return true if the stream is open
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Get the size of the blob
+         * @return int Size in bytes
+         */
+        int size() const;
+        /**
+         * @brief Get the current position
+         * @return int Offset of the next read or write
+         */
+        int tell() const;
+        /**
+         * @brief Set the current position
+         * @param position Offset from the start of the blob, at most size()
+         * @throw SQLiteException if position is out of the blob
+         */
+        void seek(int position);
+
+        /**
+         * @brief Read from the current position and advance it
+         * @param buffer Destination buffer
+         * @param count Maximum number of bytes to read
+         * @return size_t Bytes read, less than count at the end of the blob
+         * @throw SQLiteException on error
+         */
+        size_t read(char *buffer, size_t count);
+        /**
+         * @brief Write at the current position and advance it
+         * @param data Bytes to write
+         * @param count Number of bytes, the blob must be large enough
+         * @throw SQLiteException on error or if the write would go past the end
+         */
+        void write(const char *data, size_t count);
+
+    private:
+        void check() const;
+
+        std::shared_ptr<_BlobStreamData> d;
+    };
+}
+#endif	/* BLOBSTREAM_H */
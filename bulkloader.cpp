@@ -0,0 +1,701 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   BulkLoader.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:40 PM
+ */
+
+#include "bulkloader.h"
+#include "cursor.h"
+#include "mappedfile.h"
+#include "preparedstatement.h"
+#include "sqliteexception.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace SQLPP
+{
+    namespace
+    {
+        /* One parsed field, text and blobs point into the file or into the chunk bytes */
+        struct Value
+        {
+            int type;
+            int size;
+
+            union
+            {
+                int64_t integer;
+                double real;
+                const char *text;
+            };
+        };
+
+        struct Chunk
+        {
+            const char *begin = nullptr;
+            const char *end = nullptr;
+            size_t rows = 0;
+            std::vector<Value> values;
+            /* Unescaped quoted fields, reserved once so the pointers stay valid */
+            std::vector<char> bytes;
+        };
+
+        /* First delimiter, '\n' or '\r' in [p, end), or end */
+        const char * findSpecial(const char *p, const char *end, char delimiter)
+        {
+#if defined(__SSE2__)
+            const __m128i delimiters = _mm_set1_epi8(delimiter);
+            const __m128i newlines = _mm_set1_epi8('\n');
+            const __m128i returns = _mm_set1_epi8('\r');
+            while (end - p >= 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *> (p));
+                __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, delimiters),
+                                                         _mm_cmpeq_epi8(block, newlines)),
+                                            _mm_cmpeq_epi8(block, returns));
+                int mask = _mm_movemask_epi8(hits);
+                if (mask != 0) {
+                    return p + __builtin_ctz(mask);
+                }
+                p += 16;
+            }
+#endif
+            while (p < end && *p != delimiter && *p != '\n' && *p != '\r') {
+                p++;
+            }
+            return p;
+        }
+
+        /*
+         * End of the chunk starting at p (a record boundary) : just after the
+         * first newline outside quotes at or after target, or end.
+         */
+        const char * findBoundary(const char *p, const char *end, const char *target, char quote)
+        {
+            if (target >= end) {
+                return end;
+            }
+            if (quote == 0) {
+                const char *newline = static_cast<const char *> (::memchr(target, '\n', end - target));
+                return newline != nullptr ? newline + 1 : end;
+            }
+            bool quoted = false;
+#if defined(__SSE2__)
+            const __m128i quotes = _mm_set1_epi8(quote);
+            const __m128i newlines = _mm_set1_epi8('\n');
+            // Up to the target only the parity of the quote count matters
+            while (target - p >= 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *> (p));
+                int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, quotes));
+                quoted ^= (__builtin_popcount(mask) & 1) != 0;
+                p += 16;
+            }
+#endif
+            for (; p < target; p++) {
+                if (*p == quote) {
+                    quoted = !quoted;
+                }
+            }
+#if defined(__SSE2__)
+            while (end - p >= 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *> (p));
+                int quoteMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, quotes));
+                int newlineMask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, newlines));
+                if (quoteMask == 0) {
+                    if (!quoted && newlineMask != 0) {
+                        return p + __builtin_ctz(newlineMask) + 1;
+                    }
+                    p += 16;
+                    continue;
+                }
+                for (const char *blockEnd = p + 16; p < blockEnd; p++) {
+                    if (*p == quote) {
+                        quoted = !quoted;
+                    } else if (*p == '\n' && !quoted) {
+                        return p + 1;
+                    }
+                }
+            }
+#endif
+            for (; p < end; p++) {
+                if (*p == quote) {
+                    quoted = !quoted;
+                } else if (*p == '\n' && !quoted) {
+                    return p + 1;
+                }
+            }
+            return end;
+        }
+
+        bool parseInteger(const char *s, size_t n, int64_t &value)
+        {
+            size_t i = 0;
+            bool negative = false;
+            if (n > 0 && (s[0] == '-' || s[0] == '+')) {
+                negative = s[0] == '-';
+                i = 1;
+            }
+            if (i == n || n - i > 19) {
+                return false;
+            }
+            uint64_t v = 0;
+            for (; i < n; i++) {
+                unsigned digit = static_cast<unsigned char> (s[i]) - '0';
+                if (digit > 9) {
+                    return false;
+                }
+                v = v * 10 + digit;
+            }
+            const uint64_t max = static_cast<uint64_t> (std::numeric_limits<int64_t>::max());
+            if (v > max + (negative ? 1 : 0)) {
+                return false;
+            }
+            if (negative) {
+                value = v == max + 1 ? std::numeric_limits<int64_t>::min() : -static_cast<int64_t> (v);
+            } else {
+                value = static_cast<int64_t> (v);
+            }
+            return true;
+        }
+
+        bool parseReal(const char *s, size_t n, double &value)
+        {
+            char buffer[64];
+            if (n == 0 || n >= sizeof (buffer)) {
+                return false;
+            }
+            // Plain decimal notation only, strtod would also take inf, nan and hex
+            bool digit = false;
+            for (size_t i = 0; i < n; i++) {
+                char c = s[i];
+                if (c >= '0' && c <= '9') {
+                    digit = true;
+                } else if (c != '+' && c != '-' && c != '.' && c != 'e' && c != 'E') {
+                    return false;
+                }
+            }
+            if (!digit) {
+                return false;
+            }
+            ::memcpy(buffer, s, n);
+            buffer[n] = 0;
+            char *parsed;
+            value = ::strtod(buffer, &parsed);
+            return parsed == buffer + n;
+        }
+
+        class Parser
+        {
+        public:
+            /* autoTypes replaces FieldType::Auto column by column, its size is the column count */
+            Parser(const BulkLoadOptions &options, const std::vector<FieldType> &autoTypes)
+            : delimiter(options.delimiter), quote(options.quote), emptyIsNull(options.emptyIsNull),
+            columns(autoTypes.size()), types(autoTypes)
+            {
+                for (size_t i = 0; i < columns && i < options.columnTypes.size(); i++) {
+                    if (options.columnTypes[i] != FieldType::Auto) {
+                        types[i] = options.columnTypes[i];
+                    }
+                }
+            }
+
+            /* Parse the records of [chunk.begin, chunk.end), columns 0 accepts any field count */
+            void parse(Chunk &chunk) const
+            {
+                const char *p = chunk.begin;
+                const char *end = chunk.end;
+                chunk.values.reserve((end - p) / 8);
+                while (p < end) {
+                    // Blank lines hold no record
+                    if (*p == '\n') {
+                        p++;
+                        continue;
+                    }
+                    if (*p == '\r' && p + 1 < end && p[1] == '\n') {
+                        p += 2;
+                        continue;
+                    }
+                    size_t field = 0;
+                    while (true) {
+                        const char *text;
+                        size_t size;
+                        bool quoted = quote != 0 && p < end && *p == quote;
+                        if (quoted) {
+                            p = parseQuoted(p, end, chunk, text, size);
+                        } else {
+                            text = p;
+                            p = findSpecial(p, end, delimiter);
+                            // A lone \r is data
+                            while (p < end && *p == '\r' && !(p + 1 < end && p[1] == '\n')) {
+                                p = findSpecial(p + 1, end, delimiter);
+                            }
+                            size = p - text;
+                        }
+                        if (columns != 0 && field == columns) {
+                            throw SQLiteException(-1, "BulkLoader::load - A record has more than "
+                                                  + std::to_string(columns) + " fields");
+                        }
+                        chunk.values.push_back(convert(text, size, quoted, columns != 0 ? types[field] : FieldType::Text));
+                        field++;
+                        if (p < end && *p == delimiter) {
+                            p++;
+                            continue;
+                        }
+                        // End of the record
+                        if (p < end && *p == '\r') {
+                            p++;
+                        }
+                        if (p < end && *p == '\n') {
+                            p++;
+                        }
+                        break;
+                    }
+                    for (; columns != 0 && field < columns; field++) {
+                        Value null;
+                        null.type = SQLITE_NULL;
+                        null.size = 0;
+                        null.text = nullptr;
+                        chunk.values.push_back(null);
+                    }
+                    chunk.rows++;
+                }
+            }
+
+            /* Skip the blank lines at begin, then return the fields of the first record as text and its end */
+            static std::vector<std::string> firstRecord(const BulkLoadOptions &options, const char *&begin,
+                                                        const char *end, const char *&recordEnd)
+            {
+                while (begin < end && (*begin == '\n' || (*begin == '\r' && begin + 1 < end && begin[1] == '\n'))) {
+                    begin += *begin == '\n' ? 1 : 2;
+                }
+                recordEnd = findBoundary(begin, end, begin, options.quote);
+                BulkLoadOptions text = options;
+                text.emptyIsNull = false;
+                // No column count yet, every field is kept as text
+                Parser parser(text, std::vector<FieldType>());
+                Chunk chunk;
+                chunk.begin = begin;
+                chunk.end = recordEnd;
+                parser.parse(chunk);
+                std::vector<std::string> fields;
+                for (const Value &value : chunk.values) {
+                    fields.push_back(std::string(value.text, value.size));
+                }
+                return fields;
+            }
+
+        private:
+            /* Parse the quoted field at p, return the position after the closing quote */
+            const char * parseQuoted(const char *p, const char *end, Chunk &chunk, const char *&text, size_t &size) const
+            {
+                const char *start = p + 1;
+                const char *close = static_cast<const char *> (::memchr(start, quote, end - start));
+                if (close == nullptr) {
+                    throw SQLiteException(-1, "BulkLoader::load - Unterminated quoted field");
+                }
+                if (close + 1 >= end || close[1] != quote) {
+                    text = start;
+                    size = close - start;
+                    p = close + 1;
+                } else {
+                    // Doubled quotes, copy the field without them
+                    if (chunk.bytes.capacity() == 0) {
+                        chunk.bytes.reserve(chunk.end - chunk.begin);
+                    }
+                    size_t offset = chunk.bytes.size();
+                    while (true) {
+                        chunk.bytes.insert(chunk.bytes.end(), start, close);
+                        if (close + 1 < end && close[1] == quote) {
+                            chunk.bytes.push_back(quote);
+                            start = close + 2;
+                            close = static_cast<const char *> (::memchr(start, quote, end - start));
+                            if (close == nullptr) {
+                                throw SQLiteException(-1, "BulkLoader::load - Unterminated quoted field");
+                            }
+                            continue;
+                        }
+                        break;
+                    }
+                    text = chunk.bytes.data() + offset;
+                    size = chunk.bytes.size() - offset;
+                    p = close + 1;
+                }
+                // Anything between the closing quote and the delimiter is ignored
+                if (p < end && *p != delimiter && *p != '\n' && *p != '\r') {
+                    p = findSpecial(p, end, delimiter);
+                }
+                return p;
+            }
+
+            Value convert(const char *text, size_t size, bool quoted, FieldType type) const
+            {
+                Value value;
+                value.size = static_cast<int> (size);
+                value.text = text;
+                if (size == 0 && !quoted && emptyIsNull) {
+                    value.type = SQLITE_NULL;
+                    return value;
+                }
+                switch (type) {
+                case FieldType::Auto:
+                    if (parseInteger(text, size, value.integer)) {
+                        value.type = SQLITE_INTEGER;
+                    } else if (parseReal(text, size, value.real)) {
+                        value.type = SQLITE_FLOAT;
+                    } else {
+                        value.type = SQLITE_TEXT;
+                        value.text = text;
+                    }
+                    break;
+                case FieldType::Integer:
+                    value.type = SQLITE_INTEGER;
+                    if (!parseInteger(text, size, value.integer)) {
+                        value.type = SQLITE_TEXT;
+                        value.text = text;
+                    }
+                    break;
+                case FieldType::Real:
+                    value.type = SQLITE_FLOAT;
+                    if (!parseReal(text, size, value.real)) {
+                        value.type = SQLITE_TEXT;
+                        value.text = text;
+                    }
+                    break;
+                case FieldType::Text:
+                    value.type = SQLITE_TEXT;
+                    break;
+                case FieldType::Blob:
+                    value.type = SQLITE_BLOB;
+                    break;
+                }
+                return value;
+            }
+
+            char delimiter;
+            char quote;
+            bool emptyIsNull;
+            size_t columns;
+            std::vector<FieldType> types;
+        };
+
+        /* Chunks handed out to the parsers and given back to the binder in file order */
+        class Pipeline
+        {
+        public:
+            Pipeline(const BulkLoadOptions &options, const Parser &parser, const char *begin, const char *end, size_t threads)
+            : parser(parser), split(begin), end(end), quote(options.quote),
+            chunkBytes(std::max<size_t>(options.chunkBytes, 4096)), window(threads * 2)
+            {
+                for (size_t i = 0; i < threads; i++) {
+                    workers.emplace_back([this]() {
+                        work();
+                    });
+                }
+            }
+
+            ~Pipeline()
+            {
+                {
+                    std::lock_guard<std::mutex> l(mutex);
+                    stop = true;
+                }
+                changed.notify_all();
+                for (auto &worker : workers) {
+                    worker.join();
+                }
+            }
+
+            /* Next chunk in file order, null at the end of the file */
+            std::unique_ptr<Chunk> take()
+            {
+                std::unique_lock<std::mutex> l(mutex);
+                changed.wait(l, [this]() {
+                    return error || ready.count(bound) != 0 || (split >= end && bound == handedOut);
+                });
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                auto it = ready.find(bound);
+                if (it == ready.end()) {
+                    return nullptr;
+                }
+                std::unique_ptr<Chunk> chunk = std::move(it->second);
+                ready.erase(it);
+                bound++;
+                l.unlock();
+                changed.notify_all();
+                return chunk;
+            }
+
+        private:
+            void work()
+            {
+                while (true) {
+                    std::unique_ptr<Chunk> chunk(new Chunk);
+                    size_t index;
+                    {
+                        std::unique_lock<std::mutex> l(mutex);
+                        changed.wait(l, [this]() {
+                            return stop || split >= end || handedOut - bound < window;
+                        });
+                        if (stop || split >= end) {
+                            return;
+                        }
+                        // Cutting at record boundaries is the only serial step
+                        chunk->begin = split;
+                        const char *target = static_cast<size_t> (end - split) > chunkBytes ? split + chunkBytes : end;
+                        chunk->end = findBoundary(split, end, target, quote);
+                        split = chunk->end;
+                        index = handedOut++;
+                    }
+                    try {
+                        parser.parse(*chunk);
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> l(mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                        stop = true;
+                        changed.notify_all();
+                        return;
+                    }
+                    {
+                        std::lock_guard<std::mutex> l(mutex);
+                        ready[index] = std::move(chunk);
+                    }
+                    changed.notify_all();
+                }
+            }
+
+            const Parser &parser;
+            std::mutex mutex;
+            std::condition_variable changed;
+            const char *split;
+            const char *end;
+            char quote;
+            size_t chunkBytes;
+            size_t window;
+            size_t handedOut = 0;
+            size_t bound = 0;
+            bool stop = false;
+            std::exception_ptr error;
+            std::map<size_t, std::unique_ptr<Chunk> > ready;
+            std::vector<std::thread> workers;
+        };
+
+        /* Auto only parses numbers for the columns whose affinity would convert them anyway */
+        FieldType autoType(std::string declType)
+        {
+            std::transform(declType.begin(), declType.end(), declType.begin(), ::toupper);
+            if (declType.find("INT") != std::string::npos) {
+                return FieldType::Auto;
+            }
+            // TEXT affinity, or none (BLOB): the field is stored as written
+            if (declType.empty() || declType.find("CHAR") != std::string::npos || declType.find("CLOB") != std::string::npos
+                || declType.find("TEXT") != std::string::npos || declType.find("BLOB") != std::string::npos) {
+                return FieldType::Text;
+            }
+            return FieldType::Auto;
+        }
+
+        std::string quoteIdentifier(const std::string &name)
+        {
+            std::string quoted = "\"";
+            for (char c : name) {
+                quoted += c;
+                if (c == '"') {
+                    quoted += '"';
+                }
+            }
+            return quoted + "\"";
+        }
+    }
+
+    BulkLoader::BulkLoader(Database *db) : db(db)
+    {
+    }
+
+    BulkLoadResult BulkLoader::load(const std::string &fileName, const std::string &table, const BulkLoadOptions &options)
+    {
+        if (db == nullptr) {
+            throw SQLiteException(-1, "BulkLoader::load - Database pointer is null");
+        }
+        if (options.delimiter == '\n' || options.delimiter == '\r' || options.delimiter == options.quote) {
+            throw SQLiteException(-1, "BulkLoader::load - Invalid delimiter");
+        }
+        auto start = std::chrono::steady_clock::now();
+        _MappedFile file;
+        file.open(fileName, true);
+        BulkLoadResult result;
+        BulkLoadProgress progress;
+        progress.totalBytes = file.size();
+        const char *data = file.data();
+        const char *end = data + file.size();
+        // Skip a UTF-8 byte order mark
+        if (file.size() >= 3 && ::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+            data += 3;
+        }
+        if (data == end) {
+            result.completed = true;
+            return result;
+        }
+
+        // Declared types by column name, in table order
+        std::vector<std::pair<std::string, std::string> > declared;
+        {
+            PreparedStatement info = db->prepareStatement("select name, type from pragma_table_info(?) order by cid");
+            info.setString(1, table);
+            Cursor cursor = info.execute();
+            while (cursor.next()) {
+                declared.push_back(std::make_pair(cursor.getAsString(0), cursor.getAsString(1)));
+            }
+        }
+        if (declared.empty()) {
+            throw SQLiteException(-1, "BulkLoader::load - No such table: " + table);
+        }
+
+        std::string sql = "insert into " + quoteIdentifier(table);
+        size_t columns;
+        std::vector<FieldType> autoTypes;
+        if (options.header) {
+            const char *recordEnd;
+            std::vector<std::string> names = Parser::firstRecord(options, data, end, recordEnd);
+            if (names.empty()) {
+                result.completed = true;
+                return result;
+            }
+            columns = names.size();
+            sql += " (";
+            for (size_t i = 0; i < columns; i++) {
+                sql += (i > 0 ? ", " : "") + quoteIdentifier(names[i]);
+                // An unknown name fails when the insert is prepared
+                FieldType type = FieldType::Text;
+                for (const auto &column : declared) {
+                    if (sqlite3_stricmp(column.first.c_str(), names[i].c_str()) == 0) {
+                        type = autoType(column.second);
+                        break;
+                    }
+                }
+                autoTypes.push_back(type);
+            }
+            sql += ")";
+            data = recordEnd;
+        } else {
+            // Without names every column of the table gets a value, NULL when a record is short
+            columns = declared.size();
+            for (const auto &column : declared) {
+                autoTypes.push_back(autoType(column.second));
+            }
+        }
+        sql += " values (";
+        for (size_t i = 0; i < columns; i++) {
+            sql += i > 0 ? ", ?" : "?";
+        }
+        sql += ")";
+        PreparedStatement insert = db->prepareStatement(sql);
+        progress.bytes = data - file.data();
+
+        size_t threads = options.parserThreads;
+        if (threads == 0) {
+            unsigned cores = std::thread::hardware_concurrency();
+            threads = cores > 1 ? cores - 1 : 1;
+        }
+        Parser parser(options, autoTypes);
+        Pipeline pipeline(options, parser, data, end, threads);
+
+        std::unique_ptr<Chunk> chunk;
+        size_t row = 0;
+        bool cancelled = false;
+        BatchOptions batch;
+        batch.commitEvery = options.rowsPerTransaction;
+        insert.executeMany(PreparedStatement::RowProducer([&](PreparedStatement &stmt) {
+            while (!chunk || row == chunk->rows) {
+                if (chunk) {
+                    // The last row of the chunk has run, its memory can go
+                    progress.rows += chunk->rows;
+                    progress.bytes += chunk->end - chunk->begin;
+                    chunk.reset();
+                    progress.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    if (options.progress && !options.progress(progress)) {
+                        cancelled = true;
+                        return false;
+                    }
+                }
+                chunk = pipeline.take();
+                row = 0;
+                if (!chunk) {
+                    return false;
+                }
+            }
+            sqlite3_stmt *handle = stmt.d->stmt;
+            const Value *values = chunk->values.data() + row * columns;
+            for (size_t i = 0; i < columns; i++) {
+                const Value &value = values[i];
+                int column = static_cast<int> (i + 1);
+                switch (value.type) {
+                case SQLITE_INTEGER:
+                    sqlite3_bind_int64(handle, column, value.integer);
+                    break;
+                case SQLITE_FLOAT:
+                    sqlite3_bind_double(handle, column, value.real);
+                    break;
+                case SQLITE_TEXT:
+                    sqlite3_bind_text(handle, column, value.text, value.size, SQLITE_STATIC);
+                    break;
+                case SQLITE_BLOB:
+                    sqlite3_bind_blob(handle, column, value.text, value.size, SQLITE_STATIC);
+                    break;
+                default:
+                    sqlite3_bind_null(handle, column);
+                    break;
+                }
+            }
+            row++;
+            return true;
+        }), batch);
+
+        result.completed = !cancelled;
+        result.rows = progress.rows;
+        result.bytes = progress.bytes;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+}
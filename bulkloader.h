@@ -0,0 +1,187 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   BulkLoader.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:40 PM
+ */
+
+#ifndef BULKLOADER_H
+#define	BULKLOADER_H
+#include "database.hpp"
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SQLPP
+{
+    /**
+     * @brief Conversion applied to the fields of a column by BulkLoader.
+     */
+    enum class FieldType
+    {
+        /**
+         * Text for columns with TEXT or no affinity, so "007" stays "007".
+         * Otherwise integer if the field is an integer, else real if it is a
+         * number, else text, as the column affinity would convert it
+         */
+        Auto,
+        /** Bound as an integer, as text if the field is not an integer */
+        Integer,
+        /** Bound as a double, as text if the field is not a number */
+        Real,
+        /** Bound as text */
+        Text,
+        /** Bound as a blob holding the raw bytes of the field */
+        Blob
+    };
+
+    /**
+     * @brief State of a running load, given to BulkLoadOptions::progress.
+     */
+    struct BulkLoadProgress
+    {
+        /** Rows inserted so far */
+        uint64_t rows = 0;
+        /** Bytes of the file consumed so far */
+        uint64_t bytes = 0;
+        /** Size of the file */
+        uint64_t totalBytes = 0;
+        /** Time since the start of the load */
+        double seconds = 0;
+
+        double rowsPerSecond() const
+        {
+            return seconds > 0 ? rows / seconds : 0;
+        }
+    };
+
+    /**
+     * @brief Outcome of BulkLoader::load.
+     */
+    struct BulkLoadResult
+    {
+        /** false if the progress callback cancelled the load */
+        bool completed = false;
+        /** Rows inserted */
+        uint64_t rows = 0;
+        /** Bytes of the file consumed */
+        uint64_t bytes = 0;
+        /** Wall time of the load */
+        double seconds = 0;
+
+        double rowsPerSecond() const
+        {
+            return seconds > 0 ? rows / seconds : 0;
+        }
+    };
+
+    /**
+     * @brief Settings of BulkLoader::load.
+     */
+    struct BulkLoadOptions
+    {
+        /** Field separator, ',' for CSV and '\t' for TSV */
+        char delimiter = ',';
+        /** Quote character, "" inside quotes is one quote. 0 disables quoting (plain TSV) */
+        char quote = '"';
+        /** The first record names the columns of the table to fill */
+        bool header = true;
+        /** An empty unquoted field is inserted as NULL */
+        bool emptyIsNull = true;
+        /** Conversion of each column, missing entries are FieldType::Auto */
+        std::vector<FieldType> columnTypes;
+        /** Parser threads, 0 uses one per core minus the binding thread */
+        size_t parserThreads = 0;
+        /** Bytes parsed at once by a parser thread */
+        size_t chunkBytes = 4 * 1024 * 1024;
+        /** Rows inserted per transaction */
+        size_t rowsPerTransaction = 100000;
+        /** Called after every chunk, return false to stop the load */
+        std::function<bool(const BulkLoadProgress &)> progress;
+
+        /**
+         * @brief Options for tab separated files without quoting
+         * @return BulkLoadOptions '\t' delimiter, no quote character
+         */
+        static BulkLoadOptions tsv()
+        {
+            BulkLoadOptions options;
+            options.delimiter = '\t';
+            options.quote = 0;
+            return options;
+        }
+    };
+
+    /**
+     * @brief Loads CSV and TSV files into a table.
+     *
+     * The file is mapped in memory and cut into chunks at record
+     * boundaries. Parser threads split the chunks into fields, scanning for
+     * delimiters and newlines 16 bytes at a time with SSE2 when available,
+     * and convert each field to its column type. The calling thread binds
+     * the parsed rows, in file order, to a single insert statement that
+     * runs in transactions of rowsPerTransaction rows.
+     *
+     * @code
+     * SQLPP::BulkLoader loader(&db);
+     * SQLPP::BulkLoadResult result = loader.load("users.csv", "users");
+     * @endcode
+     *
+     * Fields are bound without copy. Records with fewer fields than the
+     * header (or than the table columns when there is no header) get NULL
+     * for the missing ones, records with more fields are an error. Blank
+     * lines are skipped. Lines may end with \n or \r\n; quoted fields may span lines.
+     */
+    class BulkLoader
+    {
+    public:
+        /**
+         * @brief Construct a new Bulk Loader object
+         * @param db Pointer to the Database object, the statement and transactions run on it
+         */
+        BulkLoader(Database *db);
+
+        /**
+         * @brief Insert the records of a file into a table
+         *
+         * With options.header the first record gives the columns to fill,
+         * otherwise the fields fill the table columns in order. On error the
+         * current transaction is rolled back, the transactions committed
+         * before stay.
+         * @param fileName The CSV or TSV file
+         * @param table Name of an existing table
+         * @param options Format, conversions, threads and progress callback
+         * @return BulkLoadResult Number of rows and rows per second
+         * @throw SQLiteException on a read, parse or insert error
+         */
+        BulkLoadResult load(const std::string &fileName, const std::string &table,
+                            const BulkLoadOptions &options = BulkLoadOptions());
+    private:
+        Database *db;
+    };
+}
+#endif	/* BULKLOADER_H */
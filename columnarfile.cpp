@@ -0,0 +1,552 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ColumnarFile.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 11:40 PM
+ */
+
+#include "columnarfile.h"
+#include "exportwriter.h"
+#include "sqliteexception.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace SQLPP
+{
+    namespace
+    {
+        const char magic[8] = {'S', 'Q', 'L', 'P', 'P', 'C', 'O', 'L'};
+        const uint32_t formatVersion = 1;
+        const uint32_t plainEncoding = 0;
+        const uint32_t dictionaryEncoding = 1;
+
+        struct BufferRef
+        {
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        /* Chunk descriptor as stored in the footer */
+        struct ChunkEntry
+        {
+            uint32_t encoding;
+            uint32_t reserved;
+            uint64_t nullCount;
+            uint64_t dictionarySize;
+            BufferRef nulls;
+            BufferRef values;
+            BufferRef offsets;
+            BufferRef bytes;
+        };
+
+        /* SQLite affinity rules, NUMERIC and untyped columns are kept as text */
+        ColumnType affinity(std::string declared)
+        {
+            std::transform(declared.begin(), declared.end(), declared.begin(), ::toupper);
+            if (declared.find("INT") != std::string::npos) {
+                return ColumnType::Int64;
+            }
+            if (declared.find("CHAR") != std::string::npos || declared.find("CLOB") != std::string::npos
+                || declared.find("TEXT") != std::string::npos) {
+                return ColumnType::Text;
+            }
+            if (declared.find("BLOB") != std::string::npos) {
+                return ColumnType::Blob;
+            }
+            if (declared.find("REAL") != std::string::npos || declared.find("FLOA") != std::string::npos
+                || declared.find("DOUB") != std::string::npos) {
+                return ColumnType::Double;
+            }
+            return ColumnType::Text;
+        }
+
+        /* Buffers appended at 8 byte aligned offsets of the file */
+        class Output
+        {
+        public:
+            explicit Output(int fd) : writer(fd)
+            {
+            }
+
+            uint64_t position() const
+            {
+                return writer.bytes();
+            }
+
+            void align()
+            {
+                static const char zeros[8] = {0};
+                size_t padding = static_cast<size_t> ((8 - position() % 8) % 8);
+                writer.append(zeros, padding);
+            }
+
+            BufferRef put(const void *data, size_t size)
+            {
+                BufferRef ref = {0, 0};
+                if (size == 0) {
+                    return ref;
+                }
+                align();
+                ref.offset = position();
+                ref.size = size;
+                writer.append(static_cast<const char *> (data), size);
+                return ref;
+            }
+
+            void flush()
+            {
+                writer.flush();
+            }
+        private:
+            ExportWriter writer;
+        };
+
+        /*
+         * Distinct values of a text batch. Entry 0 is the empty string, the
+         * code of NULL cells. The hash table holds entry + 1, 0 when free.
+         */
+        class Dictionary
+        {
+        public:
+            /* Fill codes and entries, false if there are more than maxEntries distinct values */
+            bool build(const ColumnBatch &batch, size_t maxEntries)
+            {
+                const std::vector<uint64_t> &offsets = batch.offsets();
+                const char *heap = batch.heap().data();
+                size_t rows = batch.size();
+                size_t slotCount = 16;
+                while (slotCount < 2 * (maxEntries + 1)) {
+                    slotCount *= 2;
+                }
+                slots.assign(slotCount, 0);
+                codes.resize(rows);
+                starts.assign(1, 0);
+                sizes.assign(1, 0);
+                for (size_t row = 0; row < rows; row++) {
+                    uint64_t start = offsets[row];
+                    uint64_t size = offsets[row + 1] - start;
+                    if (size == 0) {
+                        codes[row] = 0;
+                        continue;
+                    }
+                    // FNV-1a
+                    uint64_t hash = 14695981039346656037ULL;
+                    for (uint64_t i = 0; i < size; i++) {
+                        hash = (hash ^ static_cast<unsigned char> (heap[start + i])) * 1099511628211ULL;
+                    }
+                    size_t slot = static_cast<size_t> (hash) & (slotCount - 1);
+                    while (true) {
+                        uint32_t entry = slots[slot];
+                        if (entry == 0) {
+                            if (starts.size() > maxEntries) {
+                                return false;
+                            }
+                            entry = static_cast<uint32_t> (starts.size());
+                            slots[slot] = entry + 1;
+                            starts.push_back(start);
+                            sizes.push_back(size);
+                            codes[row] = entry;
+                            break;
+                        }
+                        entry--;
+                        if (sizes[entry] == size && ::memcmp(heap + starts[entry], heap + start, size) == 0) {
+                            codes[row] = entry;
+                            break;
+                        }
+                        slot = (slot + 1) & (slotCount - 1);
+                    }
+                }
+
+                // Distinct values back to back, in code order
+                entryOffsets.assign(1, 0);
+                bytes.clear();
+                for (size_t entry = 0; entry < starts.size(); entry++) {
+                    bytes.insert(bytes.end(), heap + starts[entry], heap + starts[entry] + sizes[entry]);
+                    entryOffsets.push_back(bytes.size());
+                }
+                return true;
+            }
+
+            std::vector<uint32_t> codes;
+            std::vector<uint64_t> entryOffsets;
+            std::vector<char> bytes;
+        private:
+            std::vector<uint32_t> slots;
+            std::vector<uint64_t> starts;
+            std::vector<uint64_t> sizes;
+        };
+
+        ChunkEntry writeChunk(Output &out, const ColumnBatch &batch, Dictionary &dictionary, bool useDictionary)
+        {
+            ChunkEntry chunk;
+            std::memset(&chunk, 0, sizeof (chunk));
+            size_t rows = batch.size();
+            for (uint8_t bits : batch.nulls()) {
+                chunk.nullCount += __builtin_popcount(bits);
+            }
+            if (chunk.nullCount > 0) {
+                chunk.nulls = out.put(batch.nulls().data(), batch.nulls().size());
+            }
+            switch (batch.type()) {
+            case ColumnType::Int64:
+                chunk.values = out.put(batch.ints().data(), rows * sizeof (int64_t));
+                break;
+            case ColumnType::Double:
+                chunk.values = out.put(batch.doubles().data(), rows * sizeof (double));
+                break;
+            case ColumnType::Text:
+                if (useDictionary && dictionary.build(batch, rows / 2)) {
+                    chunk.encoding = dictionaryEncoding;
+                    chunk.dictionarySize = dictionary.entryOffsets.size() - 1;
+                    chunk.values = out.put(dictionary.codes.data(), rows * sizeof (uint32_t));
+                    chunk.offsets = out.put(dictionary.entryOffsets.data(), dictionary.entryOffsets.size() * sizeof (uint64_t));
+                    chunk.bytes = out.put(dictionary.bytes.data(), dictionary.bytes.size());
+                    break;
+                }
+                // Too many distinct values, stored in row order
+                // Fall through
+            case ColumnType::Blob:
+                chunk.offsets = out.put(batch.offsets().data(), batch.offsets().size() * sizeof (uint64_t));
+                chunk.bytes = out.put(batch.heap().data(), batch.heap().size());
+                break;
+            }
+            return chunk;
+        }
+
+        void corrupt(const char *reason)
+        {
+            throw SQLiteException(SQLITE_CORRUPT, std::string("ColumnarReader::open - ") + reason);
+        }
+
+        template <typename T>
+        void putValue(std::vector<char> &footer, const T &value)
+        {
+            const char *bytes = reinterpret_cast<const char *> (&value);
+            footer.insert(footer.end(), bytes, bytes + sizeof (T));
+        }
+
+        /* Bounds checked reads of the footer */
+        class Input
+        {
+        public:
+            Input(const char *p, const char *end) : p(p), end(end)
+            {
+            }
+
+            template <typename T>
+            T get()
+            {
+                T value;
+                ::memcpy(&value, take(sizeof (T)), sizeof (T));
+                return value;
+            }
+
+            const char * take(uint64_t size)
+            {
+                if (size > static_cast<uint64_t> (end - p)) {
+                    corrupt("Truncated footer");
+                }
+                const char *data = p;
+                p += size;
+                return data;
+            }
+        private:
+            const char *p;
+            const char *end;
+        };
+    }
+
+    uint64_t ColumnarWriter::write(Cursor &cursor, const std::string &fileName, const ColumnarOptions &options)
+    {
+        if (options.rowsPerGroup == 0 || options.rowsPerGroup > UINT32_MAX) {
+            throw SQLiteException(-1, "ColumnarWriter::write - Invalid row group size");
+        }
+        int count = cursor.columnCount();
+        if (!options.columnTypes.empty() && options.columnTypes.size() != static_cast<size_t> (count)) {
+            throw SQLiteException(-1, "ColumnarWriter::write - Query returns " + std::to_string(count)
+                                  + " columns, " + std::to_string(options.columnTypes.size()) + " types are given");
+        }
+
+        std::vector<char> footer;
+        std::vector<ColumnBatch> batches;
+        for (int column = 0; column < count; column++) {
+            ColumnType type = options.columnTypes.empty() ? affinity(cursor.columnDeclaredType(column))
+                    : options.columnTypes[column];
+            batches.push_back(ColumnBatch(column, type));
+            std::string name = cursor.columnName(column);
+            putValue(footer, static_cast<uint32_t> (type));
+            putValue(footer, static_cast<uint32_t> (name.size()));
+            footer.insert(footer.end(), name.begin(), name.end());
+            footer.resize((footer.size() + 7) / 8 * 8, 0);
+        }
+
+        int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw SQLiteException(SQLITE_CANTOPEN, "ColumnarWriter::write - Cannot open " + fileName);
+        }
+        uint64_t rows = 0;
+        try {
+            {
+                Output out(fd);
+                std::vector<char> header(magic, magic + sizeof (magic));
+                putValue(header, formatVersion);
+                putValue(header, static_cast<uint32_t> (0));
+                out.put(header.data(), header.size());
+
+                std::vector<char> groups;
+                uint32_t groupCount = 0;
+                Dictionary dictionary;
+                size_t fetched;
+                while ((fetched = cursor.fetchBatch(options.rowsPerGroup, batches)) > 0) {
+                    putValue(groups, static_cast<uint64_t> (fetched));
+                    for (const auto &batch : batches) {
+                        putValue(groups, writeChunk(out, batch, dictionary, options.dictionary));
+                    }
+                    rows += fetched;
+                    groupCount++;
+                }
+
+                std::vector<char> head;
+                putValue(head, rows);
+                putValue(head, static_cast<uint32_t> (count));
+                putValue(head, groupCount);
+                out.align();
+                uint64_t footerOffset = out.position();
+                out.put(head.data(), head.size());
+                out.put(footer.data(), footer.size());
+                out.put(groups.data(), groups.size());
+                out.put(&footerOffset, sizeof (footerOffset));
+                out.put(magic, sizeof (magic));
+                out.flush();
+            }
+            int result = ::close(fd);
+            fd = -1;
+            if (result != 0) {
+                throw SQLiteException(SQLITE_IOERR, "ColumnarWriter::write - Cannot close " + fileName);
+            }
+        } catch (...) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            ::unlink(fileName.c_str());
+            throw;
+        }
+        return rows;
+    }
+
+    ColumnarReader::ColumnarReader() : d(new _ColumnarReaderData)
+    {
+    }
+
+    void ColumnarReader::open(const std::string &fileName)
+    {
+        std::shared_ptr<_ColumnarReaderData> data(new _ColumnarReaderData);
+        data->file.open(fileName, false);
+        const char *base = data->file.data();
+        uint64_t size = data->file.size();
+        if (size < 32 || ::memcmp(base, magic, sizeof (magic)) != 0
+            || ::memcmp(base + size - sizeof (magic), magic, sizeof (magic)) != 0) {
+            corrupt("Not a columnar file");
+        }
+        Input header(base + sizeof (magic), base + 16);
+        if (header.get<uint32_t>() != formatVersion) {
+            corrupt("Unsupported version");
+        }
+        Input trailer(base + size - 16, base + size - 8);
+        uint64_t footerOffset = trailer.get<uint64_t>();
+        if (footerOffset < 16 || footerOffset > size - 16 || footerOffset % 8 != 0) {
+            corrupt("Invalid footer offset");
+        }
+
+        Input footer(base + footerOffset, base + size - 16);
+        data->rows = footer.get<uint64_t>();
+        uint32_t count = footer.get<uint32_t>();
+        uint32_t groupCount = footer.get<uint32_t>();
+        for (uint32_t column = 0; column < count; column++) {
+            uint32_t type = footer.get<uint32_t>();
+            uint32_t nameSize = footer.get<uint32_t>();
+            if (type > static_cast<uint32_t> (ColumnType::Blob)) {
+                corrupt("Invalid column type");
+            }
+            const char *name = footer.take(nameSize);
+            footer.take((8 - nameSize % 8) % 8);
+            data->types.push_back(static_cast<ColumnType> (type));
+            data->names.push_back(std::string(name, nameSize));
+        }
+
+        // A buffer lies between the header and the footer, typed ones are aligned
+        auto check = [footerOffset](const BufferRef &ref, uint64_t expected) {
+            if (ref.size != expected || ref.offset % 8 != 0
+                || (ref.size > 0 && (ref.offset < 16 || ref.offset > footerOffset || ref.size > footerOffset - ref.offset))) {
+                corrupt("Invalid buffer");
+            }
+        };
+        uint64_t total = 0;
+        for (uint32_t group = 0; group < groupCount; group++) {
+            uint64_t rows = footer.get<uint64_t>();
+            if (rows == 0 || rows > data->rows - total || rows > UINT32_MAX) {
+                corrupt("Invalid row count");
+            }
+            total += rows;
+            data->groupRows.push_back(rows);
+            for (uint32_t column = 0; column < count; column++) {
+                ChunkEntry entry = footer.get<ChunkEntry>();
+                ColumnarChunk chunk;
+                chunk.columnType = data->types[column];
+                chunk.rows = static_cast<size_t> (rows);
+                chunk.dictionary = entry.encoding == dictionaryEncoding;
+                chunk.nulls = entry.nullCount;
+                if (entry.encoding > dictionaryEncoding || (chunk.dictionary && chunk.columnType != ColumnType::Text)
+                    || entry.nullCount > rows) {
+                    corrupt("Invalid chunk");
+                }
+                check(entry.nulls, entry.nullCount > 0 ? (rows + 7) / 8 : 0);
+                // Variable size bytes, the offsets are checked below
+                if (entry.bytes.size > 0) {
+                    check(entry.bytes, entry.bytes.size);
+                }
+                switch (chunk.columnType) {
+                case ColumnType::Int64:
+                case ColumnType::Double:
+                    check(entry.values, rows * 8);
+                    check(entry.offsets, 0);
+                    check(entry.bytes, 0);
+                    break;
+                case ColumnType::Text:
+                case ColumnType::Blob:
+                    {
+                        uint64_t values = chunk.dictionary ? entry.dictionarySize : rows;
+                        if (chunk.dictionary && (values == 0 || values > UINT32_MAX)) {
+                            corrupt("Invalid dictionary");
+                        }
+                        check(entry.values, chunk.dictionary ? rows * 4 : 0);
+                        check(entry.offsets, (values + 1) * 8);
+                        const uint64_t *offsets = reinterpret_cast<const uint64_t *> (base + entry.offsets.offset);
+                        // value() trusts offsets and codes, every one of them is checked here
+                        if (offsets[0] != 0 || offsets[values] != entry.bytes.size) {
+                            corrupt("Invalid offsets");
+                        }
+                        for (uint64_t i = 0; i < values; i++) {
+                            if (offsets[i] > offsets[i + 1]) {
+                                corrupt("Invalid offsets");
+                            }
+                        }
+                        if (chunk.dictionary) {
+                            const uint32_t *codes = reinterpret_cast<const uint32_t *> (base + entry.values.offset);
+                            for (uint64_t row = 0; row < rows; row++) {
+                                if (codes[row] >= values) {
+                                    corrupt("Invalid dictionary code");
+                                }
+                            }
+                        }
+                        chunk.byteOffsets = ColumnSpan<uint64_t>(offsets, static_cast<size_t> (values + 1));
+                        chunk.heap = ColumnSpan<char>(base + entry.bytes.offset, static_cast<size_t> (entry.bytes.size));
+                    }
+                    break;
+                }
+                if (entry.nulls.size > 0) {
+                    chunk.nullBits = ColumnSpan<uint8_t>(reinterpret_cast<const uint8_t *> (base + entry.nulls.offset),
+                                                         static_cast<size_t> (entry.nulls.size));
+                }
+                chunk.values = entry.values.size > 0 ? base + entry.values.offset : nullptr;
+                data->chunks.push_back(chunk);
+            }
+        }
+        if (total != data->rows) {
+            corrupt("Row groups do not match the row count");
+        }
+
+        for (uint32_t column = 0; column < count; column++) {
+            data->nameIndex.add(data->names[column].c_str(), static_cast<int> (column));
+        }
+        data->nameIndex.build();
+        d = data;
+    }
+
+    void ColumnarReader::close()
+    {
+        d.reset(new _ColumnarReaderData);
+    }
+
+    uint64_t ColumnarReader::rowCount() const
+    {
+        return d->rows;
+    }
+
+    int ColumnarReader::columnCount() const
+    {
+        return static_cast<int> (d->names.size());
+    }
+
+    const std::string & ColumnarReader::columnName(int column) const
+    {
+        if (column < 0 || column >= columnCount()) {
+            throw SQLiteException(-1, "ColumnarReader::columnName - Invalid column number");
+        }
+        return d->names[column];
+    }
+
+    ColumnType ColumnarReader::columnType(int column) const
+    {
+        if (column < 0 || column >= columnCount()) {
+            throw SQLiteException(-1, "ColumnarReader::columnType - Invalid column number");
+        }
+        return d->types[column];
+    }
+
+    int ColumnarReader::columnIndex(NameRef columnName) const
+    {
+        int column = d->nameIndex.find(columnName);
+        if (column < 0) {
+            throw SQLiteException(-1, "ColumnarReader::columnIndex - Unknown column " + columnName.str());
+        }
+        return column;
+    }
+
+    size_t ColumnarReader::groupCount() const
+    {
+        return d->groupRows.size();
+    }
+
+    uint64_t ColumnarReader::groupRows(size_t group) const
+    {
+        if (group >= groupCount()) {
+            throw SQLiteException(-1, "ColumnarReader::groupRows - Invalid row group");
+        }
+        return d->groupRows[group];
+    }
+
+    const ColumnarChunk & ColumnarReader::chunk(size_t group, int column) const
+    {
+        if (group >= groupCount() || column < 0 || column >= columnCount()) {
+            throw SQLiteException(-1, "ColumnarReader::chunk - Invalid row group or column");
+        }
+        return d->chunks[group * d->names.size() + column];
+    }
+}
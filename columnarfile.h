@@ -0,0 +1,346 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ColumnarFile.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 11:40 PM
+ */
+
+#ifndef COLUMNARFILE_H
+#define	COLUMNARFILE_H
+#include "columnbatch.h"
+#include "cursor.h"
+#include "mappedfile.h"
+#include "nameindex.h"
+#include <stdint.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Columnar file layout. Integers are in the byte order of the writer
+ * (little-endian on every supported platform), every section starts on
+ * an 8 byte boundary so mapped buffers can be used as typed arrays.
+ *
+ *   "SQLPPCOL", uint32 version (1), uint32 0
+ *   buffers of every row group
+ *   footer :
+ *     uint64 rows, uint32 columns, uint32 groups
+ *     per column : uint32 ColumnType, uint32 name size, name padded to 8 bytes
+ *     per group : uint64 rows, then per column a chunk :
+ *       uint32 encoding (0 plain, 1 dictionary), uint32 0,
+ *       uint64 null count, uint64 dictionary size,
+ *       4 x (uint64 offset, uint64 size) : nulls, values, offsets, bytes
+ *   uint64 footer offset, "SQLPPCOL"
+ *
+ * nulls holds one bit per row (bit i % 8 of byte i / 8), it is empty when
+ * the chunk has no NULL. values holds int64 or double values, or the
+ * uint32 dictionary code of each row. offsets (uint64, count + 1) and
+ * bytes hold the text or blob values of a plain chunk, or the distinct
+ * strings of a dictionary chunk. NULL cells are 0, an empty value or code 0.
+ */
+
+namespace SQLPP
+{
+    class ColumnarReader;
+
+    /**
+     * @brief Settings of ColumnarWriter::write.
+     */
+    struct ColumnarOptions
+    {
+        /** Rows per row group, each group is fetched with Cursor::fetchBatch */
+        size_t rowsPerGroup = 65536;
+        /** Type of each column, empty to use the affinity of the declared column type (Text without one) */
+        std::vector<ColumnType> columnTypes;
+        /** Store a Text chunk as codes into its distinct values when they are at most half of its rows */
+        bool dictionary = true;
+    };
+
+    /**
+     * @brief Fixed size array mapped from a columnar file, no copy is made.
+     */
+    template <typename T>
+    class ColumnSpan
+    {
+    public:
+        ColumnSpan() : values(nullptr), count(0)
+        {
+        }
+
+        ColumnSpan(const T *values, size_t count) : values(values), count(count)
+        {
+        }
+
+        const T * data() const
+        {
+            return values;
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        bool empty() const
+        {
+            return count == 0;
+        }
+
+        const T & operator[](size_t i) const
+        {
+            return values[i];
+        }
+
+        const T * begin() const
+        {
+            return values;
+        }
+
+        const T * end() const
+        {
+            return values + count;
+        }
+    private:
+        const T *values;
+        size_t count;
+    };
+
+    /**
+     * @brief One column of one row group of a columnar file.
+     *
+     * Every span points into the mapping of the ColumnarReader and is valid
+     * as long as the reader (or a copy of it) is open.
+     */
+    class ColumnarChunk
+    {
+        friend ColumnarReader;
+    public:
+        ColumnType type() const
+        {
+            return columnType;
+        }
+
+        /**
+         * @brief Get the number of rows
+         * @return size_t Rows of the row group
+         */
+        size_t size() const
+        {
+            return rows;
+        }
+
+        /**
+         * @brief Tell whether text values are dictionary encoded
+         * @return bool true if codes() and the dictionary are used, false if values are stored in row order
+         */
+        bool isDictionary() const
+        {
+            return dictionary;
+        }
+
+        uint64_t nullCount() const
+        {
+            return nulls;
+        }
+
+        bool isNull(size_t row) const
+        {
+            return !nullBits.empty() && ((nullBits[row >> 3] >> (row & 7)) & 1);
+        }
+
+        /** Null bitmap, empty when the chunk has no NULL */
+        ColumnSpan<uint8_t> nullBitmap() const
+        {
+            return nullBits;
+        }
+
+        /** Values of an Int64 chunk */
+        ColumnSpan<int64_t> ints() const
+        {
+            return ColumnSpan<int64_t>(columnType == ColumnType::Int64 ? static_cast<const int64_t *> (values) : nullptr,
+                                       columnType == ColumnType::Int64 ? rows : 0);
+        }
+
+        /** Values of a Double chunk */
+        ColumnSpan<double> doubles() const
+        {
+            return ColumnSpan<double>(columnType == ColumnType::Double ? static_cast<const double *> (values) : nullptr,
+                                      columnType == ColumnType::Double ? rows : 0);
+        }
+
+        /** Dictionary code of each row of a dictionary chunk */
+        ColumnSpan<uint32_t> codes() const
+        {
+            return ColumnSpan<uint32_t>(dictionary ? static_cast<const uint32_t *> (values) : nullptr,
+                                        dictionary ? rows : 0);
+        }
+
+        /** Text or blob value i spans [offsets()[i], offsets()[i + 1]) of bytes(), i is a row or a dictionary code */
+        ColumnSpan<uint64_t> offsets() const
+        {
+            return byteOffsets;
+        }
+
+        ColumnSpan<char> bytes() const
+        {
+            return heap;
+        }
+
+        /**
+         * @brief Get the number of distinct values of a dictionary chunk
+         * @return size_t Entries of the dictionary, 0 for a plain chunk
+         */
+        size_t dictionarySize() const
+        {
+            return dictionary ? byteOffsets.size() - 1 : 0;
+        }
+
+        /**
+         * @brief Get a text or blob value without copy
+         * @param row Row in the group
+         * @return ColumnView Pointer and size of the value, empty for NULL
+         */
+        ColumnView value(size_t row) const
+        {
+            size_t entry = dictionary ? static_cast<const uint32_t *> (values)[row] : row;
+            ColumnView view;
+            view.data = heap.data() + byteOffsets[entry];
+            view.size = static_cast<int32_t> (byteOffsets[entry + 1] - byteOffsets[entry]);
+            return view;
+        }
+
+    private:
+        ColumnType columnType = ColumnType::Int64;
+        size_t rows = 0;
+        bool dictionary = false;
+        uint64_t nulls = 0;
+        ColumnSpan<uint8_t> nullBits;
+        const void *values = nullptr;
+        ColumnSpan<uint64_t> byteOffsets;
+        ColumnSpan<char> heap;
+    };
+
+    /**
+     * @brief Writes the rows of a Cursor to a columnar file.
+     *
+     * Rows are fetched by row groups with Cursor::fetchBatch; each column of
+     * a group is written as typed arrays plus a null bitmap, text columns
+     * with few distinct values as a dictionary and uint32 codes. The buffers
+     * go to the file through an ExportWriter, large ones without copy. The
+     * footer indexing every buffer is written last.
+     */
+    class ColumnarWriter
+    {
+    public:
+        /**
+         * @brief Write the remaining rows of a cursor
+         * @param cursor Cursor positioned before the first row to write
+         * @param fileName File to create or truncate
+         * @param options Row group size, column types and dictionary encoding
+         * @return uint64_t Number of written rows
+         * @throw SQLiteException on error, the partial file is removed
+         */
+        uint64_t write(Cursor &cursor, const std::string &fileName, const ColumnarOptions &options = ColumnarOptions());
+    };
+
+    class _ColumnarReaderData
+    {
+        friend ColumnarReader;
+    public:
+        _ColumnarReaderData() : nameIndex(defaultMemoryResource())
+        {
+        }
+    private:
+        _MappedFile file;
+        uint64_t rows = 0;
+        std::vector<std::string> names;
+        std::vector<ColumnType> types;
+        _NameIndex nameIndex;
+        std::vector<uint64_t> groupRows;
+        /* groups x columns */
+        std::vector<ColumnarChunk> chunks;
+    };
+
+    /**
+     * @brief Reads a columnar file written by ColumnarWriter through a memory mapping.
+     *
+     * open() maps the file and checks the footer, the bounds of every
+     * buffer, and the offsets and dictionary codes of the text and blob
+     * chunks, so value() never reads outside the mapping. Integers and
+     * doubles are only read when the spans are used. Copies share the mapping.
+     */
+    class ColumnarReader
+    {
+    public:
+        ColumnarReader();
+
+        /**
+         * @brief Map a columnar file
+         * @param fileName File written by ColumnarWriter
+         * @throw SQLiteException with SQLITE_CANTOPEN or SQLITE_IOERR if it cannot be mapped, SQLITE_CORRUPT if it is not a valid file
+         */
+        void open(const std::string &fileName);
+        /**
+         * @brief Release the file, it is unmapped once no copy of the reader uses it
+         */
+        void close();
+
+        /**
+         * @brief Get the number of rows
+         * @return uint64_t Rows of all the row groups
+         */
+        uint64_t rowCount() const;
+        int columnCount() const;
+        const std::string & columnName(int column) const;
+        ColumnType columnType(int column) const;
+        /**
+         * @brief Find a column by name
+         * @param columnName Name of the column
+         * @return int The column index
+         * @throw SQLiteException if there is no such column
+         */
+        int columnIndex(NameRef columnName) const;
+
+        size_t groupCount() const;
+        /**
+         * @brief Get the number of rows of a row group
+         * @param group Index of the row group
+         * @return uint64_t Rows of the group
+         */
+        uint64_t groupRows(size_t group) const;
+        /**
+         * @brief Get one column of one row group
+         * @param group Index of the row group
+         * @param column Index of the column
+         * @return const ColumnarChunk& The chunk
+         * @throw SQLiteException on an invalid index
+         */
+        const ColumnarChunk & chunk(size_t group, int column) const;
+    private:
+        std::shared_ptr<_ColumnarReaderData> d;
+    };
+}
+#endif	/* COLUMNARFILE_H */
@@ -0,0 +1,149 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ColumnBatch.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 1:20 PM
+ */
+
+#ifndef COLUMNBATCH_H
+#define	COLUMNBATCH_H
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace SQLPP
+{
+    class Cursor;
+
+    /**
+     * @brief Storage type of a ColumnBatch.
+     */
+    enum class ColumnType
+    {
+        /** sqlite3_column_int64 into ints() */
+        Int64,
+        /** sqlite3_column_double into doubles() */
+        Double,
+        /** sqlite3_column_text into offsets() and heap() */
+        Text,
+        /** sqlite3_column_blob into offsets() and heap() */
+        Blob
+    };
+
+    /**
+     * @brief Values of one result column over several rows, in contiguous typed arrays.
+     *
+     * Filled by Cursor::fetchBatch(). Int64 and Double columns store one value
+     * per row (0 for NULL). Text and Blob columns store the bytes of every row
+     * back to back in heap(), row i spans [offsets()[i], offsets()[i + 1]).
+     * Bit i of nulls() (bit i % 8 of byte i / 8) is set when row i is NULL.
+     */
+    class ColumnBatch
+    {
+        friend Cursor;
+    public:
+        /**
+         * @brief Construct a new Column Batch object
+         * @param column Index of the result column (0-based)
+         * @param type Storage type
+         */
+        ColumnBatch(int column, ColumnType type) : columnIndex(column), columnType(type)
+        {
+        }
+
+        int column() const
+        {
+            return columnIndex;
+        }
+
+        ColumnType type() const
+        {
+            return columnType;
+        }
+
+        /**
+         * @brief Get the number of rows in the batch
+         * @return size_t Number of rows
+         */
+        size_t size() const
+        {
+            return rows;
+        }
+
+        const std::vector<int64_t> & ints() const
+        {
+            return intValues;
+        }
+
+        const std::vector<double> & doubles() const
+        {
+            return doubleValues;
+        }
+
+        const std::vector<uint64_t> & offsets() const
+        {
+            return byteOffsets;
+        }
+
+        const std::vector<char> & heap() const
+        {
+            return bytes;
+        }
+
+        const std::vector<uint8_t> & nulls() const
+        {
+            return nullBits;
+        }
+
+        bool isNull(size_t row) const
+        {
+            return (nullBits[row >> 3] >> (row & 7)) & 1;
+        }
+
+        /**
+         * @brief Empty the batch, keeping the allocated capacity
+         */
+        void clear()
+        {
+            rows = 0;
+            intValues.clear();
+            doubleValues.clear();
+            byteOffsets.assign(1, 0);
+            bytes.clear();
+            nullBits.clear();
+        }
+
+    private:
+        int columnIndex;
+        ColumnType columnType;
+        size_t rows = 0;
+        std::vector<int64_t> intValues;
+        std::vector<double> doubleValues;
+        std::vector<uint64_t> byteOffsets = std::vector<uint64_t>(1, 0);
+        std::vector<char> bytes;
+        std::vector<uint8_t> nullBits;
+    };
+}
+#endif	/* COLUMNBATCH_H */
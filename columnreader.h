@@ -0,0 +1,104 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ColumnReader.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 7:10 PM
+ */
+
+#ifndef COLUMNREADER_H
+#define	COLUMNREADER_H
+#include "blob.h"
+#include <sqlite3.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace SQLPP
+{
+    /* Reads one cell with the sqlite3_column_* call matching T */
+    template <typename T, typename Enable = void>
+    struct _ColumnReader;
+
+    template <typename T>
+    struct _ColumnReader<T, typename std::enable_if<std::is_integral<T>::value && (sizeof (T) <= 4)>::type>
+    {
+        static T read(sqlite3_stmt *stmt, int column)
+        {
+            return static_cast<T> (sqlite3_column_int(stmt, column));
+        }
+    };
+
+    template <typename T>
+    struct _ColumnReader<T, typename std::enable_if<std::is_integral<T>::value && (sizeof (T) > 4)>::type>
+    {
+        static T read(sqlite3_stmt *stmt, int column)
+        {
+            return static_cast<T> (sqlite3_column_int64(stmt, column));
+        }
+    };
+
+    template <typename T>
+    struct _ColumnReader<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+    {
+        static T read(sqlite3_stmt *stmt, int column)
+        {
+            return static_cast<T> (sqlite3_column_double(stmt, column));
+        }
+    };
+
+    template <>
+    struct _ColumnReader<std::string>
+    {
+        static std::string read(sqlite3_stmt *stmt, int column)
+        {
+            const char *data = reinterpret_cast<const char *> (sqlite3_column_text(stmt, column));
+            int size = sqlite3_column_bytes(stmt, column);
+            return data ? std::string(data, size) : std::string();
+        }
+    };
+
+    template <>
+    struct _ColumnReader<Blob>
+    {
+        static Blob read(sqlite3_stmt *stmt, int column)
+        {
+            const char *data = static_cast<const char *> (sqlite3_column_blob(stmt, column));
+            int size = sqlite3_column_bytes(stmt, column);
+            return Blob(size, data);
+        }
+    };
+
+    template <>
+    struct _ColumnReader<std::vector<char> >
+    {
+        static std::vector<char> read(sqlite3_stmt *stmt, int column)
+        {
+            const char *data = static_cast<const char *> (sqlite3_column_blob(stmt, column));
+            int size = sqlite3_column_bytes(stmt, column);
+            return std::vector<char>(data, data + size);
+        }
+    };
+}
+#endif	/* COLUMNREADER_H */
@@ -0,0 +1,235 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ConnectionPool.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 10:02 AM
+ */
+
+#include "connectionpool.h"
+#include "sqliteexception.h"
+#include <sqlite3.h>
+
+namespace SQLPP
+{
+    using locker = std::unique_lock<std::mutex>;
+
+    ConnectionPool::Lease::Lease(const std::shared_ptr<_ConnectionPoolData> &pool, Database *db, int slot)
+    : pool(pool), db(db), slot(slot)
+    {
+    }
+
+    ConnectionPool::Lease::Lease(Lease &&other)
+    : pool(std::move(other.pool)), db(other.db), slot(other.slot), stmt(std::move(other.stmt))
+    {
+        other.db = nullptr;
+    }
+
+    ConnectionPool::Lease & ConnectionPool::Lease::operator=(Lease &&other)
+    {
+        if (this != &other) {
+            release();
+            pool = std::move(other.pool);
+            db = other.db;
+            slot = other.slot;
+            stmt = std::move(other.stmt);
+            other.db = nullptr;
+        }
+        return *this;
+    }
+
+    ConnectionPool::Lease::~Lease()
+    {
+        release();
+    }
+
+    Database & ConnectionPool::Lease::database()
+    {
+        if (db == nullptr) {
+            throw SQLiteException(-1, "ConnectionPool::Lease - Lease has been released");
+        }
+        return *db;
+    }
+
+    PreparedStatement & ConnectionPool::Lease::statement()
+    {
+        if (!stmt) {
+            throw SQLiteException(-1, "ConnectionPool::Lease - Lease holds no statement");
+        }
+        return *stmt;
+    }
+
+    bool ConnectionPool::Lease::isWriter() const
+    {
+        return slot < 0;
+    }
+
+    void ConnectionPool::Lease::release()
+    {
+        if (db == nullptr) {
+            return;
+        }
+        // The statement goes back to the connection cache before the connection is reused
+        stmt.reset();
+        db = nullptr;
+        giveBack(*pool, slot);
+        pool.reset();
+    }
+
+    void ConnectionPool::Lease::prepare(const std::string &sql)
+    {
+        stmt.reset(new PreparedStatement(db->prepareStatement(sql)));
+    }
+
+    ConnectionPool::ConnectionPool() : d(new _ConnectionPoolData)
+    {
+    }
+
+    ConnectionPool::~ConnectionPool()
+    {
+    }
+
+    void ConnectionPool::open(const std::string &dbName, size_t readerCount, size_t statementCacheCapacity)
+    {
+        if (readerCount == 0) {
+            throw SQLiteException(-1, "ConnectionPool::open - At least one reader is required");
+        }
+        std::shared_ptr<_ConnectionPoolData> data(new _ConnectionPoolData);
+
+        // Leases give exclusive use of a connection, neither SQLite nor the wrapper needs to lock it
+        data->writer.reset(new Database);
+        data->writer->setHandlePolicy(HandlePolicy::SingleThread);
+        OpenOptions writerOptions;
+        writerOptions.threading = ThreadingMode::MultiThread;
+        writerOptions.journalMode = JournalMode::Wal;
+        data->writer->open(dbName, writerOptions);
+        data->writer->setStatementCacheCapacity(statementCacheCapacity);
+
+        for (size_t i = 0; i < readerCount; i++) {
+            std::unique_ptr<Database> reader(new Database);
+            reader->setHandlePolicy(HandlePolicy::SingleThread);
+            OpenOptions readerOptions;
+            readerOptions.readOnly = true;
+            readerOptions.threading = ThreadingMode::MultiThread;
+            reader->open(dbName, readerOptions);
+            reader->setStatementCacheCapacity(statementCacheCapacity);
+            data->readers.push_back(std::move(reader));
+            data->freeReaders.push_back(i);
+        }
+        d = data;
+    }
+
+    void ConnectionPool::close()
+    {
+        // Connections are closed when the last outstanding lease is released
+        d.reset(new _ConnectionPoolData);
+    }
+
+    size_t ConnectionPool::readerCount() const
+    {
+        return d->readers.size();
+    }
+
+    ConnectionPool::Lease ConnectionPool::acquireReader()
+    {
+        if (d->readers.empty()) {
+            throw SQLiteException(-1, "ConnectionPool::acquireReader - Pool is not open");
+        }
+        locker l(d->mutex);
+        d->available.wait(l, [this]() {
+            return !d->freeReaders.empty();
+        });
+        // Most recently released reader first, its caches are warm
+        size_t slot = d->freeReaders.back();
+        d->freeReaders.pop_back();
+        return Lease(d, d->readers[slot].get(), static_cast<int> (slot));
+    }
+
+    ConnectionPool::Lease ConnectionPool::acquireWriter()
+    {
+        if (!d->writer) {
+            throw SQLiteException(-1, "ConnectionPool::acquireWriter - Pool is not open");
+        }
+        locker l(d->mutex);
+        d->available.wait(l, [this]() {
+            return !d->writerBusy;
+        });
+        d->writerBusy = true;
+        return Lease(d, d->writer.get(), -1);
+    }
+
+    ConnectionPool::Lease ConnectionPool::prepareStatement(const std::string &sql)
+    {
+        bool known = false;
+        bool readOnly = false;
+        bool writerFree = false;
+        {
+            locker l(d->mutex);
+            auto it = d->readOnlySql.find(sql);
+            if (it != d->readOnlySql.end()) {
+                known = true;
+                readOnly = it->second;
+            } else if (d->writer && !d->writerBusy) {
+                // Unknown SQL goes to the idle writer, a write is then compiled once
+                d->writerBusy = true;
+                writerFree = true;
+            }
+        }
+
+        if (!known) {
+            // Never wait for the writer here, the caller may hold its lease
+            Lease lease = writerFree ? Lease(d, d->writer.get(), -1) : acquireReader();
+            lease.prepare(sql);
+            readOnly = lease.statement().isReadOnly();
+            {
+                locker l(d->mutex);
+                if (d->readOnlySql.size() >= _ConnectionPoolData::readOnlySqlCapacity) {
+                    // Forgotten texts are only routed once more
+                    d->readOnlySql.clear();
+                }
+                d->readOnlySql[sql] = readOnly;
+            }
+            if (readOnly != lease.isWriter()) {
+                return lease;
+            }
+        }
+
+        Lease lease = readOnly ? acquireReader() : acquireWriter();
+        lease.prepare(sql);
+        return lease;
+    }
+
+    void ConnectionPool::giveBack(_ConnectionPoolData &data, int slot)
+    {
+        {
+            locker l(data.mutex);
+            if (slot < 0) {
+                data.writerBusy = false;
+            } else {
+                data.freeReaders.push_back(static_cast<size_t> (slot));
+            }
+        }
+        data.available.notify_all();
+    }
+}
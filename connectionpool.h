@@ -0,0 +1,172 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ConnectionPool.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 10:02 AM
+ */
+
+#ifndef CONNECTIONPOOL_H
+#define	CONNECTIONPOOL_H
+#include "database.hpp"
+#include "preparedstatement.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SQLPP
+{
+    class ConnectionPool;
+
+    class _ConnectionPoolData
+    {
+        friend ConnectionPool;
+    private:
+        std::unique_ptr<Database> writer;
+        std::vector<std::unique_ptr<Database> > readers;
+        std::vector<size_t> freeReaders;
+        bool writerBusy = false;
+        /* Read-only status of the SQL texts routed so far, cleared when full */
+        static const size_t readOnlySqlCapacity = 1024;
+        std::unordered_map<std::string, bool> readOnlySql;
+        std::mutex mutex;
+        std::condition_variable available;
+    };
+
+    /**
+     * @brief A pool of connections to one WAL database : one writer and many readers.
+     *
+     * Readers are opened with SQLITE_OPEN_READONLY and can run concurrently,
+     * each lease gives exclusive use of one connection until it is released.
+     * prepareStatement() routes a statement to a reader when
+     * sqlite3_stmt_readonly() reports it as read-only and to the writer otherwise.
+     * Explicit transactions (BEGIN ... COMMIT) must use acquireWriter().
+     */
+    class ConnectionPool
+    {
+    public:
+        /**
+         * @brief Exclusive use of one pooled connection, released on destruction.
+         */
+        class Lease
+        {
+            friend ConnectionPool;
+        public:
+            Lease(Lease &&other);
+            Lease & operator=(Lease &&other);
+            Lease(const Lease &orig) = delete;
+            Lease & operator=(const Lease &orig) = delete;
+            virtual ~Lease();
+
+            /**
+             * @brief Get the leased connection
+             * @return Database& The connection
+             */
+            Database & database();
+            /**
+             * @brief Get the statement prepared by ConnectionPool::prepareStatement
+             * @return PreparedStatement& The statement
+             * @throw SQLiteException if the lease holds no statement
+             */
+            PreparedStatement & statement();
+            /**
+             * @brief Check if the lease holds the writer connection
+             * @return true for the writer, false for a reader
+             */
+            bool isWriter() const;
+            /**
+             * @brief Close the statement and give the connection back to the pool
+             */
+            void release();
+
+        private:
+            Lease(const std::shared_ptr<_ConnectionPoolData> &pool, Database *db, int slot);
+            void prepare(const std::string &sql);
+
+            std::shared_ptr<_ConnectionPoolData> pool;
+            Database *db;
+            /* Reader index, -1 for the writer */
+            int slot;
+            std::unique_ptr<PreparedStatement> stmt;
+        };
+
+        ConnectionPool();
+        ConnectionPool(const ConnectionPool &orig) = delete;
+        virtual ~ConnectionPool();
+
+        /**
+         * @brief Open the writer and readerCount read-only connections
+         *
+         * The database is created if needed and switched to WAL journal mode.
+         * @param dbName The database file name
+         * @param readerCount Number of read-only connections (at least 1)
+         * @param statementCacheCapacity Statement cache capacity of each connection
+         * @throw SQLiteException on error
+         */
+        void open(const std::string &dbName, size_t readerCount, size_t statementCacheCapacity = 32);
+        /**
+         * @brief Close all connections
+         * @note Outstanding leases keep their connection until they are released
+         */
+        void close();
+        /**
+         * @brief Get the number of read-only connections
+         * @return size_t Number of readers
+         */
+        size_t readerCount() const;
+
+        /**
+         * @brief Wait for a free reader and lease it
+         * @return Lease The reader lease
+         */
+        Lease acquireReader();
+        /**
+         * @brief Wait for the writer and lease it
+         * @return Lease The writer lease
+         */
+        Lease acquireWriter();
+        /**
+         * @brief Prepare a statement on a reader or on the writer
+         *
+         * The statement is routed with sqlite3_stmt_readonly(). A SQL text seen
+         * for the first time is compiled on the writer when it is idle, so a
+         * write statement is compiled once; a read-only one is compiled again
+         * on a reader. When the writer is busy the text is compiled on a
+         * reader first. The result is remembered for up to 1024 texts, later
+         * calls go straight to the right connection.
+         * @param sql The SQL query string
+         * @return Lease The lease, its statement() is prepared
+         * @throw SQLiteException on error
+         */
+        Lease prepareStatement(const std::string &sql);
+
+    private:
+        static void giveBack(_ConnectionPoolData &data, int slot);
+        std::shared_ptr<_ConnectionPoolData> d;
+    };
+}
+#endif	/* CONNECTIONPOOL_H */
@@ -28,46 +28,94 @@
  */
 
 #include "cursor.h"
+#include <cstdio>
+#include <cstring>
 namespace SQLPP
 {
 
-    using locker = std::lock_guard<std::recursive_mutex>;
+    using locker = HandleLock;
 
-    Cursor::Cursor(PreparedStatement * stmt) : d(new _CursorData)
+    Cursor::Cursor(PreparedStatement * stmt)
+    : d(std::allocate_shared<_CursorData>(ResourceAllocator<_CursorData>(stmt->d->resource), *stmt, stmt->d->resource))
     {
-        locker l(d->mutex);
-        d->stmt = stmt;
+        /* A cursor shares the locking policy of its statement */
+        d->mutex.setPolicy(stmt->handlePolicy());
         /* A cursor is opened at creation*/
         d->open = true;
         stmt->d->excecuted = true;
         stmt->d->cursorClosed = false;
     }
 
-    Cursor::Cursor(const Cursor& orig)
+    Cursor::Cursor(const Cursor& orig) : d(orig.d)
+    {
+    }
+
+    Cursor::Cursor(Cursor&& orig) : d(std::move(orig.d))
     {
-        locker l(d->mutex);
-        d = orig.d;
     }
 
     Cursor::~Cursor()
     {
-        locker l(d->mutex);
-        close();
+        // Copies share the result set, only the last one closes it
+        if (d && d.use_count() == 1) {
+            close();
+        }
+    }
+
+    Cursor& Cursor::operator=(const Cursor& orig)
+    {
+        if (d != orig.d) {
+            if (d && d.use_count() == 1) {
+                close();
+            }
+            d = orig.d;
+        }
+        return *this;
+    }
+
+    Cursor& Cursor::operator=(Cursor&& orig)
+    {
+        if (this != &orig) {
+            if (d && d.use_count() == 1) {
+                close();
+            }
+            d = std::move(orig.d);
+        }
+        return *this;
     }
 
     void Cursor::close()
     {
+        if (!d) {
+            // Moved-from cursor
+            return;
+        }
         locker l(d->mutex);
         d->open = false;
-        d->stmt->d->cursorClosed = true;
+        d->stmt.d->cursorClosed = true;
     }
 
     bool Cursor::isOpen() const
     {
+        if (!d) {
+            return false;
+        }
         locker l(d->mutex);
         return d->open;
     }
 
+    void Cursor::setMemoryResource(MemoryResource *resource)
+    {
+        locker l(d->mutex);
+        d->resource = resource != nullptr ? resource : defaultMemoryResource();
+    }
+
+    MemoryResource * Cursor::memoryResource() const
+    {
+        locker l(d->mutex);
+        return d->resource;
+    }
+
     bool Cursor::next()
     {
         locker l(d->mutex);
@@ -78,7 +126,7 @@ namespace SQLPP
             return false;
         }
 
-        int result = d->stmt->next();
+        int result = d->stmt.next();
 
         if (result == SQLITE_ROW) {
             // A new row is ready
@@ -99,6 +147,203 @@ namespace SQLPP
 
     }
 
+    size_t Cursor::fetchBatch(size_t n, std::vector<ColumnBatch> &columns)
+    {
+        locker l(d->mutex);
+        for (auto &batch : columns) {
+            batch.clear();
+            if (batch.type() == ColumnType::Int64) {
+                batch.intValues.reserve(n);
+            } else if (batch.type() == ColumnType::Double) {
+                batch.doubleValues.reserve(n);
+            } else {
+                batch.byteOffsets.reserve(n + 1);
+            }
+            batch.nullBits.reserve((n + 7) / 8);
+        }
+        if (!d->open || d->needReset) {
+            return 0;
+        }
+
+        // One lock for the whole batch instead of one per row
+        HandleLock statementLock(d->stmt.d->mutex);
+        sqlite3_stmt *stmt = d->stmt.d->stmt;
+        int count = sqlite3_column_count(stmt);
+        for (auto &batch : columns) {
+            if (batch.column() < 0 || batch.column() >= count) {
+                throw SQLiteException(-1, "Cursor::fetchBatch - Invalid column number");
+            }
+        }
+
+        size_t fetched = 0;
+        while (fetched < n) {
+            int result = PreparedStatement::step(*d->stmt.d);
+            if (result == SQLITE_DONE) {
+                // No more rows
+                d->resultReady = false;
+                d->needReset = true;
+                break;
+            }
+            if (result != SQLITE_ROW) {
+                d->resultReady = false;
+                d->needReset = true;
+                throw SQLiteException(result, errorMsg());
+            }
+            d->resultReady = true;
+
+            uint8_t nullBit = static_cast<uint8_t> (1 << (fetched & 7));
+            for (auto &batch : columns) {
+                int column = batch.columnIndex;
+                if ((fetched & 7) == 0) {
+                    batch.nullBits.push_back(0);
+                }
+                bool null = sqlite3_column_type(stmt, column) == SQLITE_NULL;
+                if (null) {
+                    batch.nullBits.back() |= nullBit;
+                }
+                switch (batch.columnType) {
+                case ColumnType::Int64:
+                    batch.intValues.push_back(null ? 0 : sqlite3_column_int64(stmt, column));
+                    break;
+                case ColumnType::Double:
+                    batch.doubleValues.push_back(null ? 0.0 : sqlite3_column_double(stmt, column));
+                    break;
+                case ColumnType::Text:
+                case ColumnType::Blob:
+                    if (!null) {
+                        // sqlite3_column_bytes must be called after the conversion
+                        const char *data = batch.columnType == ColumnType::Text
+                                ? reinterpret_cast<const char *> (sqlite3_column_text(stmt, column))
+                                : static_cast<const char *> (sqlite3_column_blob(stmt, column));
+                        int size = sqlite3_column_bytes(stmt, column);
+                        batch.bytes.insert(batch.bytes.end(), data, data + size);
+                    }
+                    batch.byteOffsets.push_back(batch.bytes.size());
+                    break;
+                }
+                batch.rows++;
+            }
+            fetched++;
+        }
+        return fetched;
+    }
+
+    uint64_t Cursor::exportTo(ExportWriter &writer, ExportFormat format, const ExportOptions &options)
+    {
+        locker l(d->mutex);
+        HandleLock statementLock(d->stmt.d->mutex);
+        sqlite3_stmt *stmt = d->stmt.d->stmt;
+        int count = sqlite3_column_count(stmt);
+        bool json = format != ExportFormat::Csv;
+
+        // JSON keys are escaped once, as "name":
+        std::vector<std::string> keys;
+        if (json) {
+            for (int column = 0; column < count; column++) {
+                const char *name = sqlite3_column_name(stmt, column);
+                std::string key;
+                for (const char *p = name; *p != 0; p++) {
+                    unsigned char c = static_cast<unsigned char> (*p);
+                    if (c == '"' || c == '\\') {
+                        key += '\\';
+                        key += *p;
+                    } else if (c < 0x20) {
+                        char escaped[8];
+                        ::snprintf(escaped, sizeof (escaped), "\\u%04x", c);
+                        key += escaped;
+                    } else {
+                        key += *p;
+                    }
+                }
+                keys.push_back((column == 0 ? "{\"" : ",\"") + key + "\":");
+            }
+        } else if (options.header) {
+            for (int column = 0; column < count; column++) {
+                if (column > 0) {
+                    writer.append(options.delimiter);
+                }
+                const char *name = sqlite3_column_name(stmt, column);
+                writer.appendCsv(name, ::strlen(name), options.delimiter);
+            }
+            writer.append('\n');
+        }
+        if (format == ExportFormat::Json) {
+            writer.append('[');
+        }
+
+        uint64_t rows = 0;
+        while (d->open && !d->needReset) {
+            int result = PreparedStatement::step(*d->stmt.d);
+            if (result == SQLITE_DONE) {
+                d->resultReady = false;
+                d->needReset = true;
+                break;
+            }
+            if (result != SQLITE_ROW) {
+                d->resultReady = false;
+                d->needReset = true;
+                throw SQLiteException(result, errorMsg());
+            }
+            d->resultReady = true;
+
+            if (format == ExportFormat::Json) {
+                writer.append(rows == 0 ? "\n" : ",\n", rows == 0 ? 1 : 2);
+            }
+            for (int column = 0; column < count; column++) {
+                if (json) {
+                    writer.append(keys[column].data(), keys[column].size());
+                } else if (column > 0) {
+                    writer.append(options.delimiter);
+                }
+                int type = sqlite3_column_type(stmt, column);
+                if (type == SQLITE_NULL) {
+                    if (json) {
+                        writer.append("null", 4);
+                    }
+                    continue;
+                }
+                if (type == SQLITE_BLOB) {
+                    const char *data = static_cast<const char *> (sqlite3_column_blob(stmt, column));
+                    int size = sqlite3_column_bytes(stmt, column);
+                    if (json) {
+                        writer.append('"');
+                    }
+                    writer.appendBase64(data, size);
+                    if (json) {
+                        writer.append('"');
+                    }
+                    continue;
+                }
+                // sqlite3_column_bytes must be called after the conversion
+                const char *text = reinterpret_cast<const char *> (sqlite3_column_text(stmt, column));
+                int size = sqlite3_column_bytes(stmt, column);
+                if (!json) {
+                    writer.appendCsv(text, size, options.delimiter);
+                } else if (type == SQLITE_TEXT) {
+                    writer.appendJson(text, size);
+                } else if (type == SQLITE_FLOAT && (text[0] == 'I' || (text[0] == '-' && text[1] == 'I'))) {
+                    // Inf and -Inf have no JSON form
+                    writer.append("null", 4);
+                } else {
+                    writer.append(text, size);
+                }
+            }
+            if (json) {
+                writer.append(count == 0 ? "{}" : "}", count == 0 ? 2 : 1);
+            }
+            if (format != ExportFormat::Json) {
+                writer.append('\n');
+            }
+            rows++;
+        }
+
+        if (format == ExportFormat::Json) {
+            writer.append(rows == 0 ? "]\n" : "\n]\n", rows == 0 ? 2 : 3);
+        }
+        writer.flush();
+        return rows;
+    }
+
     void Cursor::check()
     {
         locker l(d->mutex);
@@ -107,93 +352,210 @@ namespace SQLPP
         }
     }
 
-    int32_t Cursor::getAsInt(const std::string &columnName)
+    ColumnRef Cursor::column(NameRef columnName)
     {
+        return d->stmt.column(columnName);
+    }
 
-        return getAsInt(d->stmt->columnNumber(columnName));
+    int Cursor::columnCount()
+    {
+        HandleLock l(d->stmt.d->mutex);
+        return sqlite3_column_count(d->stmt.d->stmt);
+    }
+
+    std::string Cursor::columnName(int column)
+    {
+        HandleLock l(d->stmt.d->mutex);
+        if (column < 0 || column >= sqlite3_column_count(d->stmt.d->stmt)) {
+            throw SQLiteException(-1, "Cursor::columnName - Invalid column number");
+        }
+        return sqlite3_column_name(d->stmt.d->stmt, column);
+    }
+
+    std::string Cursor::columnDeclaredType(int column)
+    {
+        HandleLock l(d->stmt.d->mutex);
+        if (column < 0 || column >= sqlite3_column_count(d->stmt.d->stmt)) {
+            throw SQLiteException(-1, "Cursor::columnDeclaredType - Invalid column number");
+        }
+        const char *type = sqlite3_column_decltype(d->stmt.d->stmt, column);
+        return type != nullptr ? type : "";
+    }
+
+    const int * Cursor::rowLayout(const void *key, const char * const *names, size_t count)
+    {
+        auto &layouts = d->stmt.d->rowLayouts;
+        for (const auto &layout : layouts) {
+            if (layout.first == key) {
+                return layout.second.data();
+            }
+        }
+        std::vector<int> columns(count);
+        for (size_t i = 0; i < count; i++) {
+            columns[i] = d->stmt.d->columnsNames.find(names[i]);
+            if (columns[i] < 0) {
+                throw SQLiteException(-1, std::string("Cursor::read - No column for field ") + names[i]);
+            }
+        }
+        layouts.emplace_back(key, std::move(columns));
+        return layouts.back().second.data();
+    }
+
+    int32_t Cursor::getAsInt(NameRef columnName)
+    {
+
+        return getAsInt(d->stmt.columnNumber(columnName));
     }
 
     int32_t Cursor::getAsInt(int column)
     {
         locker l(d->mutex);
         check();
-        int32_t value = sqlite3_column_int(d->stmt->d->stmt, column);
+        int32_t value = sqlite3_column_int(d->stmt.d->stmt, column);
         return value;
     }
 
-    int64_t Cursor::getAsLong(const std::string &columnName)
+    int64_t Cursor::getAsLong(NameRef columnName)
     {
 
-        return getAsLong(d->stmt->columnNumber(columnName));
+        return getAsLong(d->stmt.columnNumber(columnName));
     }
 
     int64_t Cursor::getAsLong(int column)
     {
         locker l(d->mutex);
         check();
-        int64_t value = sqlite3_column_int64(d->stmt->d->stmt, column);
+        int64_t value = sqlite3_column_int64(d->stmt.d->stmt, column);
         return value;
     }
 
-    float Cursor::getAsFloat(const std::string &columnName)
+    float Cursor::getAsFloat(NameRef columnName)
     {
-        return getAsFloat(d->stmt->columnNumber(columnName));
+        return getAsFloat(d->stmt.columnNumber(columnName));
     }
 
     float Cursor::getAsFloat(int column)
     {
         locker l(d->mutex);
         check();
-        double value = sqlite3_column_double(d->stmt->d->stmt, column);
+        double value = sqlite3_column_double(d->stmt.d->stmt, column);
         return static_cast<float> (value);
     }
 
-    double Cursor::getAsDouble(const std::string &columnName)
+    double Cursor::getAsDouble(NameRef columnName)
     {
-        return getAsDouble(d->stmt->columnNumber(columnName));
+        return getAsDouble(d->stmt.columnNumber(columnName));
     }
 
     double Cursor::getAsDouble(int column)
     {
         locker l(d->mutex);
         check();
-        double value = sqlite3_column_double(d->stmt->d->stmt, column);
+        double value = sqlite3_column_double(d->stmt.d->stmt, column);
         return value;
     }
 
-    std::string Cursor::getAsString(const std::string &columnName)
+    std::string Cursor::getAsString(NameRef columnName)
     {
-        return getAsString(d->stmt->columnNumber(columnName));
+        return getAsString(d->stmt.columnNumber(columnName));
     }
 
     std::string Cursor::getAsString(int column)
+    {
+        std::string value;
+        getAsString(column, value);
+        return value;
+    }
+
+    void Cursor::getAsString(NameRef columnName, std::string &value)
+    {
+        getAsString(d->stmt.columnNumber(columnName), value);
+    }
+
+    void Cursor::getAsString(int column, std::string &value)
+    {
+        ColumnView view = getAsTextView(column);
+        value.assign(view.data, view.size);
+    }
+
+    ColumnView Cursor::getAsTextView(NameRef columnName)
+    {
+        return getAsTextView(d->stmt.columnNumber(columnName));
+    }
+
+    ColumnView Cursor::getAsTextView(int column)
     {
         locker l(d->mutex);
         check();
-        const char * data = reinterpret_cast<const char *> (sqlite3_column_text(d->stmt->d->stmt, column));
-        std::string value(data);
-        return value;
+        ColumnView view;
+        // sqlite3_column_bytes must be called after the conversion to text
+        view.data = reinterpret_cast<const char *> (sqlite3_column_text(d->stmt.d->stmt, column));
+        view.size = sqlite3_column_bytes(d->stmt.d->stmt, column);
+        if (view.data == nullptr) {
+            // NULL value
+            view.data = "";
+        }
+        return view;
     }
 
-    Blob Cursor::getAsBlob(const std::string &columnName)
+    ColumnView Cursor::getAsTextCopy(NameRef columnName)
     {
-        return getAsBlob(d->stmt->columnNumber(columnName));
+        return getAsTextCopy(d->stmt.columnNumber(columnName));
+    }
+
+    ColumnView Cursor::getAsTextCopy(int column)
+    {
+        locker l(d->mutex);
+        ColumnView view = getAsTextView(column);
+        char *copy = static_cast<char *> (d->resource->allocate(view.size + 1, 1));
+        ::memcpy(copy, view.data, view.size + 1);
+        view.data = copy;
+        return view;
+    }
+
+    Blob Cursor::getAsBlob(NameRef columnName)
+    {
+        return getAsBlob(d->stmt.columnNumber(columnName));
     }
 
     Blob Cursor::getAsBlob(int column)
     {
         locker l(d->mutex);
-        check();
-        const char * data = static_cast<const char *> (sqlite3_column_blob(d->stmt->d->stmt, column));
-        int size = sqlite3_column_bytes(d->stmt->d->stmt, column);
-        Blob blob(size, data);
+        ColumnView view = getAsBlobView(column);
+        Blob blob(view.size, view.data, d->resource);
         return blob;
     }
 
+    void Cursor::getAsBlob(NameRef columnName, std::vector<char> &value)
+    {
+        getAsBlob(d->stmt.columnNumber(columnName), value);
+    }
+
+    void Cursor::getAsBlob(int column, std::vector<char> &value)
+    {
+        ColumnView view = getAsBlobView(column);
+        value.assign(view.data, view.data + view.size);
+    }
+
+    ColumnView Cursor::getAsBlobView(NameRef columnName)
+    {
+        return getAsBlobView(d->stmt.columnNumber(columnName));
+    }
+
+    ColumnView Cursor::getAsBlobView(int column)
+    {
+        locker l(d->mutex);
+        check();
+        ColumnView view;
+        view.data = static_cast<const char *> (sqlite3_column_blob(d->stmt.d->stmt, column));
+        view.size = sqlite3_column_bytes(d->stmt.d->stmt, column);
+        return view;
+    }
+
     std::string Cursor::errorMsg()
     {
         locker l(d->mutex);
-        return d->stmt->errorMsg();
+        return d->stmt.errorMsg();
     }
 
 }
@@ -32,23 +32,46 @@
 #include "preparedstatement.h"
 #include <stdint.h>
 #include "blob.h"
+#include "columnbatch.h"
+#include "exportwriter.h"
+#include "rowmapping.h"
 #include "sqliteexception.h"
+#include <cstddef>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace SQLPP
 {
 
     class Cursor;
+
+    /**
+     * @brief Non-owning view on a text or blob cell.
+     *
+     * The data belongs to SQLite, it is valid until the next call to
+     * Cursor::next() or until the cursor is closed. Text is NUL terminated.
+     */
+    struct ColumnView
+    {
+        const char * data;
+        int32_t size;
+    };
     
     class _CursorData {
         friend Cursor;
+    public:
+        _CursorData(const PreparedStatement &stmt, MemoryResource *resource) : stmt(stmt), resource(resource) {}
     private:
-        PreparedStatement * stmt;
+        /* Shares the statement, it stays valid even if the user handle is moved */
+        PreparedStatement stmt;
         bool needReset = false;
         bool open;
         bool resultReady = false;
-        std::recursive_mutex mutex;
+        HandleMutex mutex;
+        /* Memory of the Blobs and text copies read through the cursor */
+        MemoryResource *resource;
         
     };
     
@@ -64,7 +87,19 @@ namespace SQLPP
         Cursor(PreparedStatement * stmt);
     public:
         Cursor(const Cursor& orig);
+        /**
+         * @brief Move constructor, orig no longer refers to a result set
+         *
+         * A moved-from cursor reports isOpen() false and close() does nothing.
+         * @param orig Original object
+         */
+        Cursor(Cursor&& orig);
+        /**
+         * @brief Destroy the cursor, the last copy closes it
+         */
         virtual ~Cursor();
+        Cursor& operator=(const Cursor& orig);
+        Cursor& operator=(Cursor&& orig);
 
         /**
          * @brief Close the cursor
@@ -77,6 +112,22 @@ namespace SQLPP
          */
         bool isOpen() const;
 
+        /**
+         * @brief Set the memory resource of the values copied out of the cursor
+         *
+         * getAsBlob() and getAsTextCopy() allocate from resource, e.g. a
+         * MonotonicBufferResource per request, so large reads do not go
+         * through the global heap for every row. The initial resource is the
+         * one of the database the statement was created on.
+         * @param resource The resource, it must outlive the values read with it
+         */
+        void setMemoryResource(MemoryResource *resource);
+        /**
+         * @brief Get the memory resource of the cursor
+         * @return MemoryResource* The resource
+         */
+        MemoryResource * memoryResource() const;
+
         /**
          * @brief Position the cursor on the next record if any
          * @note Must be called before retrieving values
@@ -85,12 +136,122 @@ namespace SQLPP
          */
         bool next();
 
+        /**
+         * @brief Step over up to n rows and store the requested columns in typed arrays
+         *
+         * Each batch is cleared (keeping its capacity) then receives one value
+         * per fetched row. The rows are consumed as if next() had been called
+         * for each of them, the cursor stays on the last fetched row.
+         * @param n Maximum number of rows to fetch
+         * @param columns The columns to fill, each with its index and type
+         * @return size_t Number of fetched rows, 0 at the end of the results
+         * @throw SQLiteException on error or on an invalid column index
+         */
+        size_t fetchBatch(size_t n, std::vector<ColumnBatch> &columns);
+
+        /**
+         * @brief Write the remaining rows to a writer as CSV, NDJSON or JSON
+         *
+         * Cells are copied from sqlite3_column_text / sqlite3_column_blob
+         * straight into the writer buffer, escaped on the way, with no
+         * allocation per cell. Numbers keep the SQLite text form, infinite
+         * reals are written as null in JSON. Blobs are base64 encoded.
+         * The rows are consumed as with fetchBatch(), the writer is flushed at the end.
+         * @param writer Destination of the rows
+         * @param format ExportFormat::Csv, NdJson or Json
+         * @param options Delimiter and header line (CSV only)
+         * @return uint64_t Number of written rows
+         * @throw SQLiteException on error or if the write fails
+         */
+        uint64_t exportTo(ExportWriter &writer, ExportFormat format, const ExportOptions &options = ExportOptions());
+
+        /**
+         * @brief Resolve a column name once, for repeated reads by index
+         * @param columnName Name of the column
+         * @return ColumnRef Handle accepted by every getter taking an index
+         * @throw SQLiteException if there is no such column
+         */
+        ColumnRef column(NameRef columnName);
+
+        /**
+         * @brief Get the number of columns of the results
+         * @return int Number of columns
+         */
+        int columnCount();
+
+        /**
+         * @brief Get the name of a column
+         * @param column Column number (0-based)
+         * @return std::string The name given by the query
+         * @throw SQLiteException on an invalid column number
+         */
+        std::string columnName(int column);
+
+        /**
+         * @brief Get the declared type of a column
+         * @param column Column number (0-based)
+         * @return std::string The type of the table column, empty for an expression
+         * @throw SQLiteException on an invalid column number
+         */
+        std::string columnDeclaredType(int column);
+
+        /**
+         * @brief Decode the current row into a struct declared with SQLPP_FIELDS
+         *
+         * The column of each field is looked up by name the first time the
+         * struct is read from the statement, then every row is decoded by index.
+         * @param row Receives the fields
+         * @throw SQLiteException if there is no current row or a field has no column
+         */
+        template <typename Row>
+        void read(Row &row)
+        {
+            HandleLock l(d->mutex);
+            check();
+            decode(row);
+        }
+
+        /**
+         * @brief Decode the current row into a struct declared with SQLPP_FIELDS
+         * @return Row The decoded row
+         * @throw SQLiteException if there is no current row or a field has no column
+         */
+        template <typename Row>
+        Row read()
+        {
+            Row row;
+            read(row);
+            return row;
+        }
+
+        /**
+         * @brief Step over up to maxRows rows and append them to rows
+         *
+         * The rows are consumed as if next() had been called for each of them.
+         * @param rows Receives the decoded rows
+         * @param maxRows Maximum number of rows to read, all the remaining rows by default
+         * @return size_t Number of appended rows
+         * @throw SQLiteException on error or if a field has no column
+         */
+        template <typename Row>
+        size_t readAll(std::vector<Row> &rows, size_t maxRows = static_cast<size_t> (-1))
+        {
+            HandleLock l(d->mutex);
+            size_t count = 0;
+            while (count < maxRows && next()) {
+                rows.emplace_back();
+                decode(rows.back());
+                count++;
+            }
+            return count;
+        }
+
         /**
          * @brief Get column value as integer by name
          * @param columnName Name of the column
          * @return int32_t value
          */
-        int32_t getAsInt(const std::string &columnName);
+        int32_t getAsInt(NameRef columnName);
         /**
          * @brief Get column value as integer by index
          * @param column Index of the column (0-based)
@@ -103,7 +264,7 @@ namespace SQLPP
          * @param columnName Name of the column
          * @return int64_t value
          */
-        int64_t getAsLong(const std::string &columnName);
+        int64_t getAsLong(NameRef columnName);
         /**
          * @brief Get column value as 64-bit integer by index
          * @param column Index of the column (0-based)
@@ -116,7 +277,7 @@ namespace SQLPP
          * @param columnName Name of the column
          * @return float value
          */
-        float getAsFloat(const std::string &columnName);
+        float getAsFloat(NameRef columnName);
         /**
          * @brief Get column value as float by index
          * @param column Index of the column (0-based)
@@ -129,7 +290,7 @@ namespace SQLPP
          * @param columnName Name of the column
          * @return double value
          */
-        double getAsDouble(const std::string &columnName);
+        double getAsDouble(NameRef columnName);
         /**
          * @brief Get column value as double by index
          * @param column Index of the column (0-based)
@@ -142,26 +303,86 @@ namespace SQLPP
          * @param columnName Name of the column
          * @return std::string value
          */
-        std::string getAsString(const std::string &columnName);
+        std::string getAsString(NameRef columnName);
         /**
          * @brief Get column value as string by index
          * @param column Index of the column (0-based)
          * @return std::string value
          */
         std::string getAsString(int column);
+        /**
+         * @brief Copy column value as string into value, reusing its capacity
+         * @param columnName Name of the column
+         * @param value Receives the text
+         */
+        void getAsString(NameRef columnName, std::string &value);
+        /**
+         * @brief Copy column value as string into value, reusing its capacity
+         * @param column Index of the column (0-based)
+         * @param value Receives the text
+         */
+        void getAsString(int column, std::string &value);
+        /**
+         * @brief Get column value as text without copying it
+         * @param columnName Name of the column
+         * @return ColumnView valid until the next call to next()
+         */
+        ColumnView getAsTextView(NameRef columnName);
+        /**
+         * @brief Get column value as text without copying it
+         * @param column Index of the column (0-based)
+         * @return ColumnView valid until the next call to next()
+         */
+        ColumnView getAsTextView(int column);
+        /**
+         * @brief Copy column value as text into the cursor memory resource
+         * @param columnName Name of the column
+         * @return ColumnView valid as long as the memory resource, NUL terminated
+         */
+        ColumnView getAsTextCopy(NameRef columnName);
+        /**
+         * @brief Copy column value as text into the cursor memory resource
+         * @param column Index of the column (0-based)
+         * @return ColumnView valid as long as the memory resource, NUL terminated
+         */
+        ColumnView getAsTextCopy(int column);
 
         /**
          * @brief Get column value as Blob by name
          * @param columnName Name of the column
          * @return Blob value
          */
-        Blob getAsBlob(const std::string &columnName);
+        Blob getAsBlob(NameRef columnName);
         /**
          * @brief Get column value as Blob by index
          * @param column Index of the column (0-based)
          * @return Blob value
          */
         Blob getAsBlob(int column);
+        /**
+         * @brief Copy column value as blob into value, reusing its capacity
+         * @param columnName Name of the column
+         * @param value Receives the bytes
+         */
+        void getAsBlob(NameRef columnName, std::vector<char> &value);
+        /**
+         * @brief Copy column value as blob into value, reusing its capacity
+         * @param column Index of the column (0-based)
+         * @param value Receives the bytes
+         */
+        void getAsBlob(int column, std::vector<char> &value);
+        /**
+         * @brief Get column value as blob without copying it
+         * @param columnName Name of the column
+         * @return ColumnView valid until the next call to next()
+         */
+        ColumnView getAsBlobView(NameRef columnName);
+        /**
+         * @brief Get column value as blob without copying it
+         * @param column Index of the column (0-based)
+         * @return ColumnView valid until the next call to next(), data is null for an empty blob
+         */
+        ColumnView getAsBlobView(int column);
 
         /**
          * @brief Get the last error message from SQLite
@@ -170,6 +391,18 @@ namespace SQLPP
         std::string errorMsg();
     private:
         void check();
+        /* Columns of the fields of a mapped struct, resolved once per statement */
+        const int * rowLayout(const void *key, const char * const *names, size_t count);
+
+        template <typename Row>
+        void decode(Row &row)
+        {
+            const size_t count = _RowFieldCount<Row>::value;
+            HandleLock statementLock(d->stmt.d->mutex);
+            const int *columns = rowLayout(_rowMappingKey<Row>(), RowMapping<Row>::names(), count);
+            _FieldDecoder<0, count>::decode(d->stmt.d->stmt, columns, RowMapping<Row>::members(), row);
+        }
+
         std::shared_ptr<_CursorData> d;
     };
 }
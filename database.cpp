@@ -31,30 +31,314 @@
 #include "preparedstatement.h"
 #include "sqliteexception.h"
 #include <sqlite3.h>
+#include <chrono>
+#include <thread>
 
 namespace SQLPP {
-using locker = std::lock_guard<std::recursive_mutex>;
+using locker = HandleLock;
 
-Database::Database() : d(new _DatabaseData) {}
+Database::Database() : d(new _DatabaseData) {
+  d->mutex.setPolicy(defaultHandlePolicy());
+}
+
+Database::~Database() {
+  stopWorker();
+  d->statementCache.clear();
+  sqlite3_close_v2(d->db);
+}
+
+void Database::open(const std::string &dbName) { open(dbName, OpenOptions()); }
+
+void Database::open(const std::string &dbName, ThreadingMode mode) {
+  OpenOptions options;
+  options.threading = mode;
+  open(dbName, options);
+}
+
+void Database::setHandlePolicy(HandlePolicy policy) {
+  d->mutex.setPolicy(policy);
+}
+
+HandlePolicy Database::handlePolicy() const { return d->mutex.policy(); }
+
+void Database::setMemoryResource(MemoryResource *resource) {
+  d->memoryResource = resource != nullptr ? resource : defaultMemoryResource();
+}
 
-Database::~Database() { sqlite3_close_v2(d->db); }
+MemoryResource *Database::memoryResource() const { return d->memoryResource; }
 
-void Database::open(const std::string &dbName) {
+void Database::open(const std::string &dbName, int flags) {
   locker l(d->mutex);
-  int result = sqlite3_open_v2(
-      dbName.c_str(), &d->db, SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE, NULL);
+  d->statementCache.clear();
+  int result = sqlite3_open_v2(dbName.c_str(), &d->db, flags, NULL);
   if (result != SQLITE_OK) {
-    throw SQLiteException(result, errorMsg());
+    // A handle is returned on most errors, it must still be closed
+    std::string msg = d->db ? errorMsg() : "Cannot open " + dbName;
+    sqlite3_close_v2(d->db);
+    d->db = nullptr;
+    throw SQLiteException(result, msg);
+  }
+}
+
+void Database::open(const std::string &dbName, const OpenOptions &options) {
+  int flags = options.readOnly ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE;
+  if (!options.readOnly && options.create) {
+    flags |= SQLITE_OPEN_CREATE;
+  }
+  if (options.threading == ThreadingMode::MultiThread) {
+    flags |= SQLITE_OPEN_NOMUTEX;
+  } else if (options.threading == ThreadingMode::Serialized) {
+    flags |= SQLITE_OPEN_FULLMUTEX;
+  }
+  std::string name = dbName;
+  if (options.uri || options.immutable) {
+    flags |= SQLITE_OPEN_URI;
+  }
+  if (options.immutable) {
+    name = immutableUri(dbName, options.uri);
+  }
+
+  locker l(d->mutex);
+  open(name, flags);
+  try {
+    applyOptions(options);
+  } catch (...) {
+    // Never leave a half configured connection behind
+    d->statementCache.clear();
+    sqlite3_close_v2(d->db);
+    d->db = nullptr;
+    throw;
+  }
+}
+
+std::string Database::immutableUri(const std::string &dbName, bool isUri) {
+  if (isUri) {
+    return dbName + (dbName.find('?') == std::string::npos ? "?" : "&") +
+           "immutable=1";
+  }
+  std::string uri("file:");
+  for (char c : dbName) {
+    if (c == '%' || c == '?' || c == '#') {
+      static const char hex[] = "0123456789ABCDEF";
+      uri += '%';
+      uri += hex[(c >> 4) & 0xF];
+      uri += hex[c & 0xF];
+    } else {
+      uri += c;
+    }
+  }
+  return uri + "?immutable=1";
+}
+
+namespace {
+// PRAGMA journal_mode answers with the mode in use after the change
+std::string setJournalMode(sqlite3 *db, const char *mode) {
+  std::string sql = std::string("PRAGMA journal_mode=") + mode;
+  sqlite3_stmt *stmt = nullptr;
+  int result = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+  if (result == SQLITE_OK) {
+    result = sqlite3_step(stmt);
+  }
+  if (result != SQLITE_ROW) {
+    std::string msg = sqlite3_errmsg(db);
+    sqlite3_finalize(stmt);
+    throw SQLiteException(result, msg);
+  }
+  const unsigned char *text = sqlite3_column_text(stmt, 0);
+  std::string current = text ? reinterpret_cast<const char *>(text) : "";
+  sqlite3_finalize(stmt);
+  return current;
+}
+} // namespace
+
+void Database::applyOptions(const OpenOptions &options) {
+  static const char *journalModes[] = {nullptr,  "DELETE", "TRUNCATE",
+                                       "PERSIST", "MEMORY", "WAL",
+                                       "OFF"};
+  static const char *synchronousModes[] = {nullptr, "OFF", "NORMAL", "FULL",
+                                           "EXTRA"};
+  static const char *tempStores[] = {nullptr, "FILE", "MEMORY"};
+
+  if (options.busyTimeout > 0) {
+    sqlite3_busy_timeout(d->db, options.busyTimeout);
+  }
+  // page_size first, it cannot change once the database is in WAL mode
+  if (options.pageSize > 0 && !options.readOnly) {
+    exec("PRAGMA page_size=" + std::to_string(options.pageSize));
+  }
+  if (options.journalMode != JournalMode::Default && !options.readOnly) {
+    // SQLite keeps the old mode when the new one is not available, e.g.
+    // WAL on a memory database or while another connection uses the file
+    const char *requested = journalModes[static_cast<int>(options.journalMode)];
+    std::string current = setJournalMode(d->db, requested);
+    if (sqlite3_stricmp(current.c_str(), requested) != 0) {
+      throw SQLiteException(-1, std::string("Database::open - journal_mode ") +
+                                    requested + " not available, the database uses " +
+                                    current);
+    }
+  }
+  if (options.synchronous != Synchronous::Default) {
+    exec(std::string("PRAGMA synchronous=") +
+         synchronousModes[static_cast<int>(options.synchronous)]);
+  }
+  if (options.cacheSize != 0) {
+    exec("PRAGMA cache_size=" + std::to_string(options.cacheSize));
+  }
+  if (options.mmapSize >= 0) {
+    exec("PRAGMA mmap_size=" + std::to_string(options.mmapSize));
+  }
+  if (options.tempStore != TempStore::Default) {
+    exec(std::string("PRAGMA temp_store=") +
+         tempStores[static_cast<int>(options.tempStore)]);
   }
 }
 
 PreparedStatement Database::prepareStatement(const std::string &sql) {
   locker l(d->mutex);
+  if (d->statementCache.capacity() == 0) {
+    PreparedStatement stmt(this);
+    stmt.prepare(sql);
+    return stmt;
+  }
+  std::shared_ptr<_PreparedStatementData> cached =
+      d->statementCache.checkout(sql);
+  if (cached) {
+    cached->mutex.setPolicy(handlePolicy());
+    cached->timing = d->statementTiming;
+    return PreparedStatement(std::move(cached));
+  }
   PreparedStatement stmt(this);
-  stmt.prepare(sql);
+  stmt.prepare(sql, SQLITE_PREPARE_PERSISTENT);
+  stmt.d->cached = true;
+  stmt.d->cacheGeneration = d->statementCache.generation();
   return stmt;
 }
 
+void Database::setStatementCacheCapacity(size_t capacity) {
+  d->statementCache.setCapacity(capacity);
+}
+
+size_t Database::statementCacheCapacity() const {
+  return d->statementCache.capacity();
+}
+
+StatementCacheStats Database::statementCacheStats() const {
+  return d->statementCache.stats();
+}
+
+void Database::clearStatementCache() { d->statementCache.clear(); }
+
+void Database::setStatementTiming(bool enabled) {
+  d->statementTiming = enabled;
+}
+
+bool Database::statementTiming() const { return d->statementTiming; }
+
+StatementStats Database::statementStats() const {
+  StatementStats total;
+  for (const auto &data : liveStatements()) {
+    // Takes the statement lock while reading its counters
+    total += PreparedStatement::collectStats(*data, false);
+  }
+  return total;
+}
+
+void Database::resetStatementStats() {
+  for (const auto &data : liveStatements()) {
+    PreparedStatement::collectStats(*data, true);
+  }
+}
+
+void Database::registerStatement(
+    const std::shared_ptr<_PreparedStatementData> &data) {
+  std::lock_guard<std::mutex> l(d->statementsMutex);
+  // Drop the expired entries whenever the registry doubles
+  if (d->statements.size() == d->statements.capacity()) {
+    std::vector<std::weak_ptr<_PreparedStatementData>> alive;
+    for (const auto &entry : d->statements) {
+      if (!entry.expired()) {
+        alive.push_back(entry);
+      }
+    }
+    d->statements.swap(alive);
+  }
+  d->statements.push_back(data);
+}
+
+std::vector<std::shared_ptr<_PreparedStatementData>>
+Database::liveStatements() const {
+  // Plain references : a statement whose handles all go away meanwhile is
+  // only finalized by its data, never recycled from the calling thread
+  std::vector<std::shared_ptr<_PreparedStatementData>> live;
+  {
+    std::lock_guard<std::mutex> l(d->statementsMutex);
+    for (const auto &entry : d->statements) {
+      std::shared_ptr<_PreparedStatementData> data = entry.lock();
+      if (data) {
+        live.push_back(std::move(data));
+      }
+    }
+  }
+  // Statement locks are only taken once the registry lock is released
+  return live;
+}
+
+void Database::recycleStatement(
+    const std::shared_ptr<_PreparedStatementData> &data) {
+  d->statementCache.checkin(data);
+}
+
+void Database::enqueue(_AsyncTask *task) {
+  std::unique_ptr<_AsyncTask> owned(task);
+  if (!d->db) {
+    throw SQLiteException(-1, "Database is closed / no database");
+  }
+  // Pushed under the lock, stopWorker() cannot delete the worker meanwhile
+  std::lock_guard<std::mutex> l(d->workerMutex);
+  if (d->workerStopping) {
+    throw SQLiteException(-1, "Database is closing, task rejected");
+  }
+  if (!d->worker) {
+    d->worker.reset(new _AsyncWorker(this));
+  }
+  d->worker->push(owned.release());
+}
+
+void Database::stopWorker() {
+  std::unique_ptr<_AsyncWorker> worker;
+  {
+    std::lock_guard<std::mutex> l(d->workerMutex);
+    d->workerStopping = true;
+    worker = std::move(d->worker);
+  }
+  // Runs the pending tasks, then joins the thread
+  worker.reset();
+}
+
+int Database::executeBound(
+    const std::string &sql,
+    const std::function<void(sqlite3_stmt *)> &bind) {
+  locker l(d->mutex);
+  PreparedStatement stmt = prepareStatement(sql);
+  locker statementLock(stmt.d->mutex);
+  sqlite3_stmt *handle = stmt.d->stmt;
+  bind(handle);
+  int result = PreparedStatement::step(*stmt.d);
+  while (result == SQLITE_ROW) {
+    result = PreparedStatement::step(*stmt.d);
+  }
+  if (result != SQLITE_DONE) {
+    std::string msg = errorMsg();
+    sqlite3_reset(handle);
+    stmt.d->clearBindings();
+    throw SQLiteException(result, msg);
+  }
+  int changes = sqlite3_changes(d->db);
+  sqlite3_reset(handle);
+  stmt.d->clearBindings();
+  return changes;
+}
+
 std::string Database::errorMsg() {
   locker l(d->mutex);
   std::string msg(sqlite3_errmsg(d->db));
@@ -62,8 +346,14 @@ std::string Database::errorMsg() {
 }
 
 void Database::close() {
+  // Queued tasks still need the connection, and the worker takes its lock
+  stopWorker();
   locker l(d->mutex);
+  d->statementCache.clear();
   sqlite3_close_v2(d->db);
+  d->db = nullptr;
+  std::lock_guard<std::mutex> workerLock(d->workerMutex);
+  d->workerStopping = false;
 }
 
 void Database::exec(std::string sql) {
@@ -77,6 +367,191 @@ void Database::exec(std::string sql) {
   }
 }
 
+int64_t Database::lastInsertRowId() {
+  locker l(d->mutex);
+  return sqlite3_last_insert_rowid(d->db);
+}
+
+BackupResult Database::backupTo(Database &dest, const BackupOptions &options) {
+  if (&dest == this || dest.d == d) {
+    throw SQLiteException(-1, "Database::backupTo - Source and destination are the same");
+  }
+  if (!d->db || !dest.d->db) {
+    throw SQLiteException(-1, "Database::backupTo - Database is closed / no database");
+  }
+  auto start = std::chrono::steady_clock::now();
+  sqlite3_backup *backup;
+  {
+    locker l(d->mutex);
+    locker destLock(dest.d->mutex);
+    backup = sqlite3_backup_init(dest.d->db, options.destSchema.c_str(), d->db,
+                                 options.sourceSchema.c_str());
+    if (backup == nullptr) {
+      throw SQLiteException(sqlite3_errcode(dest.d->db), sqlite3_errmsg(dest.d->db));
+    }
+  }
+
+  BackupResult result;
+  BackupProgress progress;
+  int copied = -1;
+  int rc = SQLITE_OK;
+  bool cancelled = false;
+  while (true) {
+    {
+      // Only hold the connections while pages are copied
+      locker l(d->mutex);
+      locker destLock(dest.d->mutex);
+      rc = sqlite3_backup_step(backup, options.pagesPerStep);
+      progress.pageCount = sqlite3_backup_pagecount(backup);
+      progress.remaining = sqlite3_backup_remaining(backup);
+    }
+    result.steps++;
+    if (rc != SQLITE_OK && rc != SQLITE_DONE && rc != SQLITE_BUSY && rc != SQLITE_LOCKED) {
+      break;
+    }
+    if (rc == SQLITE_OK || rc == SQLITE_DONE) {
+      // A successful step that did not move forward started over from the first page
+      int done = progress.pageCount - progress.remaining;
+      if (copied >= 0 && done <= copied) {
+        progress.restarts++;
+      }
+      copied = done;
+    }
+    if (options.progress && !options.progress(progress)) {
+      cancelled = true;
+      break;
+    }
+    if (rc == SQLITE_DONE) {
+      break;
+    }
+    if (options.maxRestarts > 0 && progress.restarts >= options.maxRestarts) {
+      break;
+    }
+    if (options.sleepMillis > 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(options.sleepMillis));
+    }
+  }
+
+  int finish;
+  std::string msg;
+  {
+    locker destLock(dest.d->mutex);
+    finish = sqlite3_backup_finish(backup);
+    msg = sqlite3_errmsg(dest.d->db);
+  }
+  if (rc != SQLITE_DONE && !cancelled) {
+    if (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED) {
+      throw SQLiteException(-1, "Database::backupTo - The source kept changing, gave up after " +
+                                    std::to_string(progress.restarts) + " restarts");
+    }
+    throw SQLiteException(rc, msg);
+  }
+  if (finish != SQLITE_OK) {
+    throw SQLiteException(finish, msg);
+  }
+  result.completed = !cancelled;
+  result.pageCount = progress.pageCount;
+  result.restarts = progress.restarts;
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+BackupResult Database::backupTo(const std::string &fileName, const BackupOptions &options) {
+  Database dest;
+  dest.setHandlePolicy(HandlePolicy::SingleThread);
+  dest.open(fileName);
+  return backupTo(dest, options);
+}
+
+std::future<BackupResult> Database::backupToAsync(const std::string &fileName,
+                                                  const BackupOptions &options) {
+  return std::async(std::launch::async, [this, fileName, options]() {
+    return backupTo(fileName, options);
+  });
+}
+
+namespace {
+// Bytes 18 and 19 of the header are 2 for WAL, memory databases need 1
+void clearWalMode(unsigned char *data, int64_t size) {
+  if (size >= 20 && data[18] == 2 && data[19] == 2) {
+    data[18] = 1;
+    data[19] = 1;
+  }
+}
+} // namespace
+
+DatabaseImage Database::serialize(const std::string &schema) {
+  locker l(d->mutex);
+  if (!d->db) {
+    throw SQLiteException(-1, "Database is closed / no database");
+  }
+  sqlite3_int64 size = 0;
+  unsigned char *data = sqlite3_serialize(d->db, schema.c_str(), &size, 0);
+  if (data == nullptr) {
+    if (size == 0 && sqlite3_errcode(d->db) == SQLITE_OK) {
+      // Nothing written yet
+      return DatabaseImage();
+    }
+    throw SQLiteException(SQLITE_NOMEM, "Database::serialize - Cannot serialize " + schema);
+  }
+  clearWalMode(data, size);
+  return DatabaseImage(data, size);
+}
+
+void Database::openFromImage(DatabaseImage &&image, const OpenOptions &options) {
+  int64_t size = image.size();
+  unsigned char *data = image.release();
+  unsigned int flags = SQLITE_DESERIALIZE_FREEONCLOSE;
+  if (options.readOnly) {
+    flags |= SQLITE_DESERIALIZE_READONLY;
+  } else {
+    flags |= SQLITE_DESERIALIZE_RESIZEABLE;
+  }
+  if (data != nullptr) {
+    clearWalMode(data, size);
+  }
+  deserialize(data, size, flags, options);
+}
+
+void Database::openFromImage(const void *data, int64_t size, const OpenOptions &options) {
+  if (!options.readOnly) {
+    openFromImage(DatabaseImage::copyOf(data, size), options);
+    return;
+  }
+  deserialize(static_cast<unsigned char *>(const_cast<void *>(data)), size,
+              SQLITE_DESERIALIZE_READONLY, options);
+}
+
+void Database::deserialize(unsigned char *data, int64_t size, unsigned int flags,
+                           const OpenOptions &options) {
+  OpenOptions memory;
+  memory.threading = options.threading;
+  locker l(d->mutex);
+  try {
+    open(":memory:", memory);
+  } catch (...) {
+    if (flags & SQLITE_DESERIALIZE_FREEONCLOSE) {
+      sqlite3_free(data);
+    }
+    throw;
+  }
+  // On failure SQLite frees a FREEONCLOSE buffer itself
+  int result = sqlite3_deserialize(d->db, "main", data, size, size, flags);
+  try {
+    if (result != SQLITE_OK) {
+      throw SQLiteException(result, errorMsg());
+    }
+    // Check the header now rather than on the first query
+    exec("select count(*) from sqlite_schema");
+    applyOptions(options);
+  } catch (...) {
+    d->statementCache.clear();
+    sqlite3_close_v2(d->db);
+    d->db = nullptr;
+    throw;
+  }
+}
+
 void Database::begin() {
   locker l(d->mutex);
   exec("begin");
@@ -30,22 +30,51 @@
 #ifndef DATABASE_HPP
 #define	DATABASE_HPP
 #include <sqlite3.h>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <string>
 #include <memory>
 #include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "asyncworker.h"
+#include "backupoptions.h"
+#include "databaseimage.h"
+#include "handlepolicy.h"
+#include "memoryresource.h"
+#include "openoptions.h"
+#include "statementcache.h"
+#include "statementstats.h"
+#include "tuplebinder.h"
 
 namespace SQLPP
 {
     class PreparedStatement;
     class Database;
+    class BlobStream;
 
     class _DatabaseData
     {
         friend Database;
+        friend _AsyncWorker;
     private:
         sqlite3 * db = 0;
         bool inTransaction = false;
-        std::recursive_mutex mutex;
+        HandleMutex mutex;
+        StatementCache statementCache;
+        // Statements prepared on the connection, for the statistics aggregate
+        std::mutex statementsMutex;
+        std::vector<std::weak_ptr<_PreparedStatementData> > statements;
+        bool statementTiming = false;
+        // Worker thread of submit() and executeAsync(), started by the first task
+        std::mutex workerMutex;
+        std::unique_ptr<_AsyncWorker> worker;
+        // Set while close() stops the worker, new tasks are rejected
+        bool workerStopping = false;
+        MemoryResource *memoryResource = defaultMemoryResource();
     };
 
     /**
@@ -58,6 +87,9 @@ namespace SQLPP
     {
     public:
         friend PreparedStatement;
+        friend BlobStream;
+        friend _AsyncStatement;
+        friend _AsyncWorker;
         /**
          * @brief Construct a new Database object
          */
@@ -78,6 +110,68 @@ namespace SQLPP
          * @throw SQLiteException on error
          */
         void open(const std::string & dbName);
+        /**
+         * @brief Open database with explicit sqlite3_open_v2 flags
+         * @param dbName The database file name
+         * @param flags SQLITE_OPEN_* flags (e.g. SQLITE_OPEN_READONLY)
+         * @throw SQLiteException on error
+         */
+        void open(const std::string & dbName, int flags);
+        /**
+         * @brief Open database with an explicit SQLite threading mode
+         *
+         * Create a new database file if it does not exist. When the caller
+         * guarantees one thread per connection, pair ThreadingMode::MultiThread
+         * with setHandlePolicy(HandlePolicy::SingleThread) to drop both the
+         * SQLite and the wrapper mutexes.
+         * @param dbName The database file name
+         * @param mode The threading mode
+         * @throw SQLiteException on error
+         */
+        void open(const std::string & dbName, ThreadingMode mode);
+        /**
+         * @brief Open database and apply the open flags and pragmas of options
+         *
+         * If a pragma fails, or SQLite keeps another journal mode than the
+         * requested one (e.g. WAL on ":memory:"), the connection is closed
+         * before the exception is thrown.
+         * @code
+         * db.open("app.db", SQLPP::OpenOptions::oltp());
+         * @endcode
+         * @param dbName The database file name (or URI with options.uri)
+         * @param options Flags and pragmas, see OpenOptions presets
+         * @throw SQLiteException on error
+         */
+        void open(const std::string & dbName, const OpenOptions &options);
+        /**
+         * @brief Set the locking policy of the connection
+         *
+         * Statements created afterwards on this connection inherit the policy.
+         * The initial policy is defaultHandlePolicy().
+         * @param policy HandlePolicy::SingleThread removes the wrapper locks
+         * @note Must be set before the connection is shared between threads
+         */
+        void setHandlePolicy(HandlePolicy policy);
+        /**
+         * @brief Get the locking policy of the connection
+         * @return HandlePolicy The policy
+         */
+        HandlePolicy handlePolicy() const;
+        /**
+         * @brief Set the memory resource of the statements created from now on
+         *
+         * Statement data and the cursors and Blobs read from them are
+         * allocated from resource. Statements may be kept by the statement
+         * cache, so the resource must outlive the connection; per-request
+         * arenas are better given to Cursor::setMemoryResource().
+         * @param resource The resource, defaultMemoryResource() initially
+         */
+        void setMemoryResource(MemoryResource *resource);
+        /**
+         * @brief Get the memory resource of new statements
+         * @return MemoryResource* The resource
+         */
+        MemoryResource * memoryResource() const;
         /**
          * @brief Close the database connection
          */
@@ -90,16 +184,187 @@ namespace SQLPP
 
         /**
          * @brief Prepare an SQL statement
+         *
+         * When the statement cache is enabled, an idle statement with the same
+         * SQL text is reused instead of being compiled again. The statement
+         * goes back to the cache when its last handle is closed or destroyed.
          * @param sql The SQL query string
          * @return PreparedStatement The prepared statement object
          */
         PreparedStatement prepareStatement(const std::string &sql);
 
+        /**
+         * @brief Set the number of idle statements kept by prepareStatement
+         * @param capacity Maximum number of cached statements, 0 disables the cache
+         */
+        void setStatementCacheCapacity(size_t capacity);
+        /**
+         * @brief Get the number of idle statements kept by prepareStatement
+         * @return size_t The cache capacity
+         */
+        size_t statementCacheCapacity() const;
+        /**
+         * @brief Get the statement cache hit, miss and eviction counters
+         * @return StatementCacheStats The counters
+         */
+        StatementCacheStats statementCacheStats() const;
+        /**
+         * @brief Finalize all idle cached statements
+         */
+        void clearStatementCache();
+
+        /**
+         * @brief Enable wall time measurement on statements created from now on
+         * @param enabled true to time the steps of new statements, false by default
+         */
+        void setStatementTiming(bool enabled);
+        /**
+         * @brief Check if new statements measure the time spent stepping
+         * @return true if timing is enabled
+         */
+        bool statementTiming() const;
+        /**
+         * @brief Get the sum of the statistics of all live statements of the connection
+         *
+         * Statements idle in the statement cache are included.
+         * @return StatementStats The aggregated counters
+         */
+        StatementStats statementStats() const;
+        /**
+         * @brief Reset the statistics of all live statements of the connection
+         */
+        void resetStatementStats();
+
+        /**
+         * @brief Run a function on the worker thread of the connection
+         *
+         * The first call starts a worker thread dedicated to the connection.
+         * Tasks go through a lock-free queue, the caller only takes a short
+         * lock to push them and does not wait for the connection lock nor
+         * for the disk. Tasks run one after the other,
+         * in submission order, with executeAsync() statements. Under the
+         * SingleThread policy the connection must not be used by other
+         * threads while tasks are pending.
+         * @param function Callable taking a Database &
+         * @return std::future of the function result, or of its exception
+         * @throw SQLiteException if the database is closed or closing
+         */
+        template <typename Function>
+        auto submit(Function function) -> std::future<decltype(function(std::declval<Database &>()))>
+        {
+            typedef decltype(function(std::declval<Database &>())) Result;
+            _AsyncCall<Result> *task = new _AsyncCall<Result>(std::move(function));
+            std::future<Result> result = task->future();
+            enqueue(task);
+            return result;
+        }
+
+        /**
+         * @brief Execute a statement on the worker thread of the connection
+         *
+         * The values are copied into the task and bound to parameters 1..N
+         * when it runs (integers, floating point, std::string, C strings,
+         * Blob or nullptr). The statement comes from prepareStatement(), so
+         * it uses the statement cache. Consecutive statements found in the
+         * queue share one transaction, each one under its own savepoint: a
+         * failing statement only rolls back its own changes.
+         * @param sql The SQL query string
+         * @param binds Values of the parameters
+         * @return std::future of the number of rows changed (sqlite3_changes)
+         * @throw SQLiteException if the database is closed
+         */
+        template <typename... Binds>
+        std::future<int> executeAsync(const std::string &sql, Binds &&... binds)
+        {
+            typedef std::tuple<typename _AsyncValue<typename std::decay<Binds>::type>::type...> Row;
+            std::shared_ptr<Row> row = std::make_shared<Row>(std::forward<Binds>(binds)...);
+            _AsyncStatement *task = new _AsyncStatement(sql, [row](sqlite3_stmt * stmt) {
+                _TupleBinder::bind(stmt, *row);
+            });
+            std::future<int> result = task->future();
+            enqueue(task);
+            return result;
+        }
+
         /**
          * @brief Execute a raw SQL statement
          * @param sql The SQL query string
          */
         void exec(std::string sql);
+        /**
+         * @brief Get the rowid of the last row inserted on the connection
+         * @return int64_t The rowid (sqlite3_last_insert_rowid)
+         */
+        int64_t lastInsertRowId();
+        /**
+         * @brief Copy the database into dest while it stays in use (sqlite3_backup_*)
+         *
+         * The pages are copied options.pagesPerStep at a time, sleeping
+         * options.sleepMillis between steps so the connection keeps serving
+         * other threads. The content of dest is replaced.
+         * @param dest Open destination database, not used by anyone else during the copy
+         * @param options Step size, throttling and progress callback
+         * @return BackupResult completed is false if the progress callback cancelled the copy
+         * @throw SQLiteException on error, or after options.maxRestarts restarts
+         */
+        BackupResult backupTo(Database &dest, const BackupOptions &options = BackupOptions());
+        /**
+         * @brief Copy the database into a file, created if needed
+         * @param fileName Destination file, its content is replaced
+         * @param options Step size, throttling and progress callback
+         * @return BackupResult completed is false if the progress callback cancelled the copy
+         * @throw SQLiteException on error, or after options.maxRestarts restarts
+         */
+        BackupResult backupTo(const std::string &fileName, const BackupOptions &options = BackupOptions());
+        /**
+         * @brief Run backupTo(fileName, options) on a new thread
+         *
+         * The connection must use the ThreadSafe handle policy and must stay
+         * open until the future is ready. The progress callback runs on the
+         * backup thread.
+         * @param fileName Destination file, its content is replaced
+         * @param options Step size, throttling and progress callback
+         * @return std::future of the result, or of the exception
+         */
+        std::future<BackupResult> backupToAsync(const std::string &fileName, const BackupOptions &options = BackupOptions());
+
+        /**
+         * @brief Copy the database into an image (sqlite3_serialize)
+         *
+         * A database in WAL mode is marked as a rollback journal database in
+         * the image, so the image can be opened in memory.
+         * @param schema Schema to copy, "main" by default
+         * @return DatabaseImage The database file content
+         * @throw SQLiteException on error
+         */
+        DatabaseImage serialize(const std::string &schema = "main");
+        /**
+         * @brief Open an in-memory database holding an image (sqlite3_deserialize)
+         *
+         * SQLite takes the image buffer over without copying it and frees it
+         * when the connection is closed. The database can grow unless
+         * options.readOnly is set. The pragmas of options are applied to the
+         * loaded database, journal modes other than memory and off are not
+         * available in memory and make the call throw.
+         * @param image The image, empty once the call returns
+         * @param options Threading mode, read-only flag and pragmas
+         * @throw SQLiteException if the image is not a valid database
+         */
+        void openFromImage(DatabaseImage &&image, const OpenOptions &options = OpenOptions());
+        /**
+         * @brief Open an in-memory database holding a copy of a database file
+         *
+         * With options.readOnly the bytes are used in place, e.g. from a
+         * mapped file, and must stay valid until the connection is closed.
+         * Otherwise they are copied first. An image used in place must not
+         * come from a database in WAL mode.
+         * @param data Database file content
+         * @param size Size in bytes
+         * @param options Threading mode, read-only flag and pragmas
+         * @throw SQLiteException if the data is not a valid database
+         */
+        void openFromImage(const void *data, int64_t size, const OpenOptions &options = OpenOptions());
+
         /**
          * @brief Begin a transaction
          */
@@ -121,6 +386,16 @@ namespace SQLPP
             return d->db;
         }
 
+        void recycleStatement(const std::shared_ptr<_PreparedStatementData> &data);
+        void registerStatement(const std::shared_ptr<_PreparedStatementData> &data);
+        std::vector<std::shared_ptr<_PreparedStatementData> > liveStatements() const;
+        void applyOptions(const OpenOptions &options);
+        void deserialize(unsigned char *data, int64_t size, unsigned int flags, const OpenOptions &options);
+        static std::string immutableUri(const std::string &dbName, bool isUri);
+        void enqueue(_AsyncTask *task);
+        void stopWorker();
+        int executeBound(const std::string &sql, const std::function<void(sqlite3_stmt *)> &bind);
+
         std::shared_ptr<_DatabaseData> d;
     };
 
@@ -0,0 +1,152 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   DatabaseImage.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:05 PM
+ */
+
+#include "databaseimage.h"
+#include "sqliteexception.h"
+#include <sqlite3.h>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace SQLPP
+{
+
+    DatabaseImage::DatabaseImage() : buffer(nullptr), length(0)
+    {
+    }
+
+    DatabaseImage::DatabaseImage(unsigned char *buffer, int64_t length) : buffer(buffer), length(length)
+    {
+    }
+
+    DatabaseImage::DatabaseImage(DatabaseImage &&orig) : buffer(orig.buffer), length(orig.length)
+    {
+        orig.buffer = nullptr;
+        orig.length = 0;
+    }
+
+    DatabaseImage & DatabaseImage::operator=(DatabaseImage &&orig)
+    {
+        if (this != &orig) {
+            sqlite3_free(buffer);
+            buffer = orig.buffer;
+            length = orig.length;
+            orig.buffer = nullptr;
+            orig.length = 0;
+        }
+        return *this;
+    }
+
+    DatabaseImage::~DatabaseImage()
+    {
+        sqlite3_free(buffer);
+    }
+
+    DatabaseImage DatabaseImage::copyOf(const void *data, int64_t size)
+    {
+        if (size <= 0) {
+            return DatabaseImage();
+        }
+        unsigned char *copy = static_cast<unsigned char *> (sqlite3_malloc64(static_cast<sqlite3_uint64> (size)));
+        if (copy == nullptr) {
+            throw SQLiteException(SQLITE_NOMEM, "DatabaseImage::copyOf - Out of memory");
+        }
+        ::memcpy(copy, data, static_cast<size_t> (size));
+        return DatabaseImage(copy, size);
+    }
+
+    DatabaseImage DatabaseImage::readFile(const std::string &fileName)
+    {
+        FILE *file = ::fopen(fileName.c_str(), "rb");
+        if (file == nullptr) {
+            throw SQLiteException(SQLITE_CANTOPEN, "DatabaseImage::readFile - Cannot open " + fileName);
+        }
+        int64_t size = -1;
+        if (::fseek(file, 0, SEEK_END) == 0) {
+            size = ::ftell(file);
+            ::fseek(file, 0, SEEK_SET);
+        }
+        if (size < 0) {
+            ::fclose(file);
+            throw SQLiteException(SQLITE_IOERR, "DatabaseImage::readFile - Cannot get the size of " + fileName);
+        }
+        DatabaseImage image;
+        if (size > 0) {
+            image.buffer = static_cast<unsigned char *> (sqlite3_malloc64(static_cast<sqlite3_uint64> (size)));
+            if (image.buffer == nullptr) {
+                ::fclose(file);
+                throw SQLiteException(SQLITE_NOMEM, "DatabaseImage::readFile - Out of memory");
+            }
+            image.length = size;
+            size_t read = ::fread(image.buffer, 1, static_cast<size_t> (size), file);
+            if (read != static_cast<size_t> (size)) {
+                ::fclose(file);
+                throw SQLiteException(SQLITE_IOERR, "DatabaseImage::readFile - Cannot read " + fileName);
+            }
+        }
+        ::fclose(file);
+        return image;
+    }
+
+    void DatabaseImage::writeFile(const std::string &fileName) const
+    {
+        FILE *file = ::fopen(fileName.c_str(), "wb");
+        if (file == nullptr) {
+            throw SQLiteException(SQLITE_CANTOPEN, "DatabaseImage::writeFile - Cannot open " + fileName);
+        }
+        size_t written = length > 0 ? ::fwrite(buffer, 1, static_cast<size_t> (length), file) : 0;
+        int closed = ::fclose(file);
+        if (written != static_cast<size_t> (length) || closed != 0) {
+            throw SQLiteException(SQLITE_IOERR, "DatabaseImage::writeFile - Cannot write " + fileName);
+        }
+    }
+
+    const unsigned char * DatabaseImage::data() const
+    {
+        return buffer;
+    }
+
+    int64_t DatabaseImage::size() const
+    {
+        return length;
+    }
+
+    bool DatabaseImage::empty() const
+    {
+        return length == 0;
+    }
+
+    unsigned char * DatabaseImage::release()
+    {
+        unsigned char *released = buffer;
+        buffer = nullptr;
+        length = 0;
+        return released;
+    }
+}
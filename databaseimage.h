@@ -0,0 +1,112 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   DatabaseImage.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:05 PM
+ */
+
+#ifndef DATABASEIMAGE_H
+#define	DATABASEIMAGE_H
+#include <stdint.h>
+#include <string>
+
+namespace SQLPP
+{
+    class Database;
+
+    /**
+     * @brief In-memory copy of a whole database file, in the SQLite file format.
+     *
+     * Produced by Database::serialize() or read from a file, and turned back
+     * into a database by Database::openFromImage(). The buffer comes from
+     * sqlite3_malloc64 so SQLite can take it over without copying it.
+     * Images are move-only.
+     */
+    class DatabaseImage
+    {
+        friend Database;
+    public:
+        /**
+         * @brief Construct an empty image
+         */
+        DatabaseImage();
+        DatabaseImage(const DatabaseImage &orig) = delete;
+        DatabaseImage & operator=(const DatabaseImage &orig) = delete;
+        /**
+         * @brief Move constructor, orig becomes empty
+         * @param orig Original object
+         */
+        DatabaseImage(DatabaseImage &&orig);
+        DatabaseImage & operator=(DatabaseImage &&orig);
+        ~DatabaseImage();
+
+        /**
+         * @brief Copy bytes into a new image
+         * @param data Database file content
+         * @param size Size in bytes
+         * @return DatabaseImage The image
+         * @throw SQLiteException if the memory cannot be allocated
+         */
+        static DatabaseImage copyOf(const void *data, int64_t size);
+        /**
+         * @brief Read a database file into a new image
+         * @param fileName The file, e.g. written by writeFile() or by SQLite
+         * @return DatabaseImage The image
+         * @throw SQLiteException if the file cannot be read
+         */
+        static DatabaseImage readFile(const std::string &fileName);
+        /**
+         * @brief Write the image to a file, which can be opened as a database
+         * @param fileName The file, replaced if it exists
+         * @throw SQLiteException if the file cannot be written
+         */
+        void writeFile(const std::string &fileName) const;
+
+        /**
+         * @brief Get the bytes of the image
+         * @return const unsigned char* The bytes, null for an empty image
+         */
+        const unsigned char * data() const;
+        /**
+         * @brief Get the size of the image
+         * @return int64_t Size in bytes
+         */
+        int64_t size() const;
+        /**
+         * @brief Check if the image holds no data
+         * @return true if empty
+         */
+        bool empty() const;
+
+    private:
+        DatabaseImage(unsigned char *buffer, int64_t length);
+        /* Give the buffer away, the image becomes empty */
+        unsigned char * release();
+
+        unsigned char *buffer;
+        int64_t length;
+    };
+}
+#endif	/* DATABASEIMAGE_H */
@@ -0,0 +1,291 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ExportWriter.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 10:30 PM
+ */
+
+#include "exportwriter.h"
+#include "sqliteexception.h"
+#include <sqlite3.h>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <sys/uio.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace SQLPP
+{
+    namespace
+    {
+        const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        /* Two base64 characters for each 12 bit value */
+        struct Base64Pairs
+        {
+            Base64Pairs()
+            {
+                for (int i = 0; i < 4096; i++) {
+                    pairs[2 * i] = base64Alphabet[i >> 6];
+                    pairs[2 * i + 1] = base64Alphabet[i & 63];
+                }
+            }
+
+            char pairs[8192];
+        };
+
+        const Base64Pairs base64;
+
+        /* First delimiter, quote, '\n' or '\r' in [p, end), or end */
+        const char * findCsvSpecial(const char *p, const char *end, char delimiter)
+        {
+#if defined(__SSE2__)
+            const __m128i delimiters = _mm_set1_epi8(delimiter);
+            const __m128i quotes = _mm_set1_epi8('"');
+            const __m128i newlines = _mm_set1_epi8('\n');
+            const __m128i returns = _mm_set1_epi8('\r');
+            while (end - p >= 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *> (p));
+                __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, delimiters),
+                                                         _mm_cmpeq_epi8(block, quotes)),
+                                            _mm_or_si128(_mm_cmpeq_epi8(block, newlines),
+                                                         _mm_cmpeq_epi8(block, returns)));
+                int mask = _mm_movemask_epi8(hits);
+                if (mask != 0) {
+                    return p + __builtin_ctz(mask);
+                }
+                p += 16;
+            }
+#endif
+            while (p < end && *p != delimiter && *p != '"' && *p != '\n' && *p != '\r') {
+                p++;
+            }
+            return p;
+        }
+
+        /* First quote, backslash or control character in [p, end), or end */
+        const char * findJsonSpecial(const char *p, const char *end)
+        {
+#if defined(__SSE2__)
+            const __m128i quotes = _mm_set1_epi8('"');
+            const __m128i backslashes = _mm_set1_epi8('\\');
+            const __m128i controls = _mm_set1_epi8(0x1F);
+            while (end - p >= 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *> (p));
+                // Unsigned x <= 0x1F <=> max(x, 0x1F) == 0x1F
+                __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, quotes),
+                                                         _mm_cmpeq_epi8(block, backslashes)),
+                                            _mm_cmpeq_epi8(_mm_max_epu8(block, controls), controls));
+                int mask = _mm_movemask_epi8(hits);
+                if (mask != 0) {
+                    return p + __builtin_ctz(mask);
+                }
+                p += 16;
+            }
+#endif
+            while (p < end && *p != '"' && *p != '\\' && static_cast<unsigned char> (*p) >= 0x20) {
+                p++;
+            }
+            return p;
+        }
+    }
+
+    ExportWriter::ExportWriter(int fd, size_t bufferBytes)
+    : fd(fd), buffer(new char[bufferBytes < 64 ? 64 : bufferBytes]),
+    capacity(bufferBytes < 64 ? 64 : bufferBytes), used(0), total(0)
+    {
+    }
+
+    ExportWriter::~ExportWriter()
+    {
+        try {
+            flush();
+        } catch (const SQLiteException &) {
+        }
+    }
+
+    void ExportWriter::flush()
+    {
+        if (used > 0) {
+            writeAll(nullptr, 0);
+        }
+    }
+
+    uint64_t ExportWriter::bytes() const
+    {
+        return total;
+    }
+
+    void ExportWriter::writeAll(const char *extra, size_t extraSize)
+    {
+        struct iovec parts[2];
+        parts[0].iov_base = buffer.get();
+        parts[0].iov_len = used;
+        parts[1].iov_base = const_cast<char *> (extra);
+        parts[1].iov_len = extraSize;
+        struct iovec *part = parts;
+        int count = extraSize > 0 ? 2 : 1;
+        // The buffer is emptied even on error, so the destructor does not write it again
+        used = 0;
+        while (count > 0) {
+            ssize_t written = ::writev(fd, part, count);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw SQLiteException(SQLITE_IOERR, std::string("ExportWriter::flush - ") + ::strerror(errno));
+            }
+            size_t left = static_cast<size_t> (written);
+            while (count > 0 && left >= part->iov_len) {
+                left -= part->iov_len;
+                part++;
+                count--;
+            }
+            if (count > 0) {
+                part->iov_base = static_cast<char *> (part->iov_base) + left;
+                part->iov_len -= left;
+            }
+        }
+    }
+
+    void ExportWriter::append(const char *data, size_t size)
+    {
+        if (size <= capacity - used) {
+            ::memcpy(buffer.get() + used, data, size);
+            used += size;
+        } else if (size >= capacity / 2) {
+            // Large value : written from where it is, in the same call as the buffer
+            writeAll(data, size);
+        } else {
+            flush();
+            ::memcpy(buffer.get(), data, size);
+            used = size;
+        }
+        total += size;
+    }
+
+    void ExportWriter::appendCsv(const char *data, size_t size, char delimiter)
+    {
+        const char *end = data + size;
+        const char *special = findCsvSpecial(data, end, delimiter);
+        if (special == end) {
+            append(data, size);
+            return;
+        }
+        append('"');
+        append(data, special - data);
+        for (const char *p = special; p < end;) {
+            // Quotes are doubled, delimiters and line breaks are kept between the quotes
+            const char *quote = static_cast<const char *> (::memchr(p, '"', end - p));
+            if (quote == nullptr) {
+                append(p, end - p);
+                break;
+            }
+            append(p, quote + 1 - p);
+            append('"');
+            p = quote + 1;
+        }
+        append('"');
+    }
+
+    void ExportWriter::appendJson(const char *data, size_t size)
+    {
+        static const char hex[] = "0123456789abcdef";
+        const char *end = data + size;
+        append('"');
+        for (const char *p = data; p < end;) {
+            const char *special = findJsonSpecial(p, end);
+            append(p, special - p);
+            if (special == end) {
+                break;
+            }
+            char *out = reserve(6);
+            unsigned char c = static_cast<unsigned char> (*special);
+            out[0] = '\\';
+            switch (c) {
+            case '"': out[1] = '"';
+                commit(2);
+                break;
+            case '\\': out[1] = '\\';
+                commit(2);
+                break;
+            case '\n': out[1] = 'n';
+                commit(2);
+                break;
+            case '\r': out[1] = 'r';
+                commit(2);
+                break;
+            case '\t': out[1] = 't';
+                commit(2);
+                break;
+            default:
+                out[1] = 'u';
+                out[2] = '0';
+                out[3] = '0';
+                out[4] = hex[c >> 4];
+                out[5] = hex[c & 15];
+                commit(6);
+                break;
+            }
+            p = special + 1;
+        }
+        append('"');
+    }
+
+    void ExportWriter::appendBase64(const char *data, size_t size)
+    {
+        const unsigned char *p = reinterpret_cast<const unsigned char *> (data);
+        const unsigned char *end = p + size / 3 * 3;
+        while (p < end) {
+            // 3 input bytes give 4 characters, converted by blocks that fit in the buffer
+            size_t groups = static_cast<size_t> (end - p) / 3;
+            if (groups > capacity / 4) {
+                groups = capacity / 4;
+            }
+            char *out = reserve(groups * 4);
+            for (size_t i = 0; i < groups; i++, p += 3, out += 4) {
+                uint32_t value = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+                ::memcpy(out, base64.pairs + 2 * (value >> 12), 2);
+                ::memcpy(out + 2, base64.pairs + 2 * (value & 0xFFF), 2);
+            }
+            commit(groups * 4);
+        }
+        size_t rest = size % 3;
+        if (rest > 0) {
+            uint32_t value = uint32_t(p[0]) << 16;
+            if (rest == 2) {
+                value |= uint32_t(p[1]) << 8;
+            }
+            char *out = reserve(4);
+            out[0] = base64Alphabet[value >> 18];
+            out[1] = base64Alphabet[(value >> 12) & 63];
+            out[2] = rest == 2 ? base64Alphabet[(value >> 6) & 63] : '=';
+            out[3] = '=';
+            commit(4);
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   ExportWriter.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 10:30 PM
+ */
+
+#ifndef EXPORTWRITER_H
+#define	EXPORTWRITER_H
+#include <stdint.h>
+#include <cstddef>
+#include <memory>
+
+namespace SQLPP
+{
+    /**
+     * @brief Output format of Cursor::exportTo.
+     */
+    enum class ExportFormat
+    {
+        /** Header line then one line per row, fields quoted when needed, blobs in base64 */
+        Csv,
+        /** One JSON object per line, blobs as base64 strings */
+        NdJson,
+        /** One JSON array of objects */
+        Json
+    };
+
+    /**
+     * @brief Settings of Cursor::exportTo.
+     */
+    struct ExportOptions
+    {
+        /** CSV field separator */
+        char delimiter = ',';
+        /** Write the column names as the first CSV line */
+        bool header = true;
+    };
+
+    /**
+     * @brief Buffered output to a file descriptor, used by Cursor::exportTo.
+     *
+     * Data is gathered in one large buffer and written with writev when the
+     * buffer is full. A value larger than half the buffer is written in the
+     * same writev call as the buffer, without being copied into it.
+     * Escaping routines scan 16 bytes at a time with SSE2 when available
+     * and copy the runs that need no escaping as a whole.
+     */
+    class ExportWriter
+    {
+    public:
+        /**
+         * @brief Construct a new Export Writer object
+         * @param fd Open file descriptor, not closed by the writer
+         * @param bufferBytes Size of the buffer
+         */
+        explicit ExportWriter(int fd, size_t bufferBytes = 1024 * 1024);
+        /**
+         * @brief Flush the buffer, errors are ignored : call flush() to see them
+         */
+        ~ExportWriter();
+        ExportWriter(const ExportWriter &orig) = delete;
+        ExportWriter & operator=(const ExportWriter &orig) = delete;
+
+        /**
+         * @brief Write the buffered data to the file descriptor
+         * @throw SQLiteException with SQLITE_IOERR if the write fails
+         */
+        void flush();
+        /**
+         * @brief Get the number of bytes given to the writer
+         * @return uint64_t Bytes, including the ones still buffered
+         */
+        uint64_t bytes() const;
+
+        /**
+         * @brief Append raw bytes
+         * @param data The bytes
+         * @param size Number of bytes
+         */
+        void append(const char *data, size_t size);
+        void append(char c)
+        {
+            if (used == capacity) {
+                flush();
+            }
+            buffer[used++] = c;
+            total++;
+        }
+        /**
+         * @brief Append a CSV field, quoted if it holds the delimiter, a quote or a line break
+         */
+        void appendCsv(const char *data, size_t size, char delimiter);
+        /**
+         * @brief Append a JSON string literal, quotes included
+         */
+        void appendJson(const char *data, size_t size);
+        /**
+         * @brief Append bytes encoded in base64, with padding
+         */
+        void appendBase64(const char *data, size_t size);
+
+    private:
+        /* Room for size bytes at the end of the buffer, size <= capacity */
+        char * reserve(size_t size)
+        {
+            if (capacity - used < size) {
+                flush();
+            }
+            return buffer.get() + used;
+        }
+
+        void commit(size_t size)
+        {
+            used += size;
+            total += size;
+        }
+
+        void writeAll(const char *extra, size_t extraSize);
+
+        int fd;
+        std::unique_ptr<char[]> buffer;
+        size_t capacity;
+        size_t used;
+        uint64_t total;
+    };
+}
+#endif	/* EXPORTWRITER_H */
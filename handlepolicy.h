@@ -0,0 +1,110 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   HandlePolicy.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 11:05 AM
+ */
+
+#ifndef HANDLEPOLICY_H
+#define	HANDLEPOLICY_H
+#include <mutex>
+
+namespace SQLPP
+{
+    /**
+     * @brief Locking policy of a handle (Database, PreparedStatement and its Cursors).
+     */
+    enum class HandlePolicy
+    {
+        /** Every operation takes the handle mutex, handles can be shared between threads */
+        ThreadSafe,
+        /** No locking at all, the caller guarantees the handle is never used by two threads at once */
+        SingleThread
+    };
+
+    /**
+     * @brief Set the policy given to Database objects created from now on
+     *
+     * A Database passes its policy to the statements and cursors created on it.
+     * @param policy HandlePolicy::SingleThread when every connection is used by one thread only
+     */
+    void setDefaultHandlePolicy(HandlePolicy policy);
+    /**
+     * @brief Get the policy given to new Database objects
+     * @return HandlePolicy The policy, ThreadSafe unless changed
+     */
+    HandlePolicy defaultHandlePolicy();
+
+    class HandleLock;
+
+    /**
+     * @brief Recursive mutex that is only taken under the ThreadSafe policy.
+     * @note The policy must be chosen before the handle is shared between threads.
+     */
+    class HandleMutex
+    {
+        friend HandleLock;
+    public:
+        void setPolicy(HandlePolicy policy)
+        {
+            threadSafe = (policy == HandlePolicy::ThreadSafe);
+        }
+
+        HandlePolicy policy() const
+        {
+            return threadSafe ? HandlePolicy::ThreadSafe : HandlePolicy::SingleThread;
+        }
+    private:
+        std::recursive_mutex mutex;
+        bool threadSafe = true;
+    };
+
+    /**
+     * @brief Scoped lock on a HandleMutex, a no-op under the SingleThread policy.
+     */
+    class HandleLock
+    {
+    public:
+        explicit HandleLock(HandleMutex &m) : mutex(m.threadSafe ? &m.mutex : nullptr)
+        {
+            if (mutex) {
+                mutex->lock();
+            }
+        }
+
+        ~HandleLock()
+        {
+            if (mutex) {
+                mutex->unlock();
+            }
+        }
+
+        HandleLock(const HandleLock &orig) = delete;
+        HandleLock & operator=(const HandleLock &orig) = delete;
+    private:
+        std::recursive_mutex *mutex;
+    };
+}
+#endif	/* HANDLEPOLICY_H */
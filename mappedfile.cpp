@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   MappedFile.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:40 PM
+ */
+
+#include "mappedfile.h"
+#include "sqliteexception.h"
+#include <sqlite3.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SQLPP
+{
+
+    _MappedFile::_MappedFile() : address(nullptr), length(0)
+    {
+    }
+
+    _MappedFile::~_MappedFile()
+    {
+        close();
+    }
+
+    void _MappedFile::open(const std::string &fileName, bool sequential)
+    {
+        close();
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw SQLiteException(SQLITE_CANTOPEN, "Cannot open " + fileName);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw SQLiteException(SQLITE_IOERR, "Cannot get the size of " + fileName);
+        }
+        if (info.st_size == 0) {
+            ::close(fd);
+            return;
+        }
+        void *mapped = ::mmap(nullptr, static_cast<size_t> (info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps the file alive
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            throw SQLiteException(SQLITE_IOERR, "Cannot map " + fileName);
+        }
+        if (sequential) {
+            ::madvise(mapped, static_cast<size_t> (info.st_size), MADV_SEQUENTIAL);
+        }
+        address = static_cast<const char *> (mapped);
+        length = static_cast<size_t> (info.st_size);
+    }
+
+    void _MappedFile::close()
+    {
+        if (address != nullptr) {
+            ::munmap(const_cast<char *> (address), length);
+            address = nullptr;
+            length = 0;
+        }
+    }
+}
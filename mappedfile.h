@@ -0,0 +1,67 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   MappedFile.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:40 PM
+ */
+
+#ifndef MAPPEDFILE_H
+#define	MAPPEDFILE_H
+#include <cstddef>
+#include <string>
+
+namespace SQLPP
+{
+    /*
+     * Read-only memory mapping of a whole file, unmapped by the destructor.
+     * An empty file maps to a null pointer and a size of 0.
+     */
+    class _MappedFile
+    {
+    public:
+        _MappedFile();
+        ~_MappedFile();
+        _MappedFile(const _MappedFile &orig) = delete;
+        _MappedFile & operator=(const _MappedFile &orig) = delete;
+
+        /* Map fileName, throws SQLiteException if it cannot be opened or mapped */
+        void open(const std::string &fileName, bool sequential);
+        void close();
+
+        const char * data() const
+        {
+            return address;
+        }
+
+        size_t size() const
+        {
+            return length;
+        }
+    private:
+        const char *address;
+        size_t length;
+    };
+}
+#endif	/* MAPPEDFILE_H */
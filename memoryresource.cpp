@@ -0,0 +1,123 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   MemoryResource.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 5:50 PM
+ */
+
+#include "memoryresource.h"
+#include <cstdlib>
+#include <stdint.h>
+
+namespace SQLPP
+{
+    namespace
+    {
+
+        class MallocResource : public MemoryResource
+        {
+        protected:
+            void * doAllocate(size_t bytes, size_t alignment) override
+            {
+                if (alignment > alignof(std::max_align_t)) {
+                    throw std::bad_alloc();
+                }
+                // malloc(0) may return nullptr, which is not an error
+                void *p = ::malloc(bytes > 0 ? bytes : 1);
+                if (p == nullptr) {
+                    throw std::bad_alloc();
+                }
+                return p;
+            }
+
+            void doDeallocate(void *p, size_t, size_t) override
+            {
+                ::free(p);
+            }
+        };
+    }
+
+    MemoryResource * defaultMemoryResource()
+    {
+        // Never destroyed, objects may be released during static destruction
+        static MallocResource *resource = new MallocResource;
+        return resource;
+    }
+
+    MonotonicBufferResource::MonotonicBufferResource(size_t initialSize, MemoryResource *upstream)
+    : upstream(upstream), nextSize(initialSize > 0 ? initialSize : 1)
+    {
+    }
+
+    MonotonicBufferResource::MonotonicBufferResource(void *buffer, size_t size, MemoryResource *upstream)
+    : upstream(upstream), initialBuffer(static_cast<char *> (buffer)), initialBufferSize(size),
+    current(static_cast<char *> (buffer)), remaining(size), nextSize(size > 0 ? size * 2 : 4096)
+    {
+    }
+
+    MonotonicBufferResource::~MonotonicBufferResource()
+    {
+        release();
+    }
+
+    void MonotonicBufferResource::release()
+    {
+        while (blocks != nullptr) {
+            Block *next = blocks->next;
+            upstream->deallocate(blocks, blocks->size);
+            blocks = next;
+        }
+        current = initialBuffer;
+        remaining = initialBufferSize;
+    }
+
+    void * MonotonicBufferResource::doAllocate(size_t bytes, size_t alignment)
+    {
+        size_t padding = (alignment - reinterpret_cast<uintptr_t> (current) % alignment) % alignment;
+        if (current == nullptr || padding + bytes > remaining) {
+            // Start a new block, large enough for the request
+            size_t size = nextSize;
+            while (size < bytes + alignment + sizeof (Block)) {
+                size *= 2;
+            }
+            Block *block = static_cast<Block *> (upstream->allocate(size));
+            block->next = blocks;
+            block->size = size;
+            blocks = block;
+            current = reinterpret_cast<char *> (block) + sizeof (Block);
+            remaining = size - sizeof (Block);
+            nextSize = size * 2;
+            padding = (alignment - reinterpret_cast<uintptr_t> (current) % alignment) % alignment;
+        }
+        char *p = current + padding;
+        current = p + bytes;
+        remaining -= padding + bytes;
+        return p;
+    }
+
+    void MonotonicBufferResource::doDeallocate(void *, size_t, size_t)
+    {
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   MemoryResource.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 5:50 PM
+ */
+
+#ifndef MEMORYRESOURCE_H
+#define	MEMORYRESOURCE_H
+#include <cstddef>
+#include <new>
+
+namespace SQLPP
+{
+    /**
+     * @brief Source of memory for the library objects, like std::pmr::memory_resource.
+     *
+     * The library is C++11, so it cannot take a std::pmr::memory_resource;
+     * a C++17 caller can wrap one in a small MemoryResource subclass.
+     * Alignments up to alignof(std::max_align_t) are supported.
+     */
+    class MemoryResource
+    {
+    public:
+        virtual ~MemoryResource()
+        {
+        }
+
+        void * allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+        {
+            return doAllocate(bytes, alignment);
+        }
+
+        void deallocate(void *p, size_t bytes, size_t alignment = alignof(std::max_align_t))
+        {
+            doDeallocate(p, bytes, alignment);
+        }
+
+        bool isEqual(const MemoryResource &other) const noexcept
+        {
+            return this == &other || doIsEqual(other);
+        }
+
+    protected:
+        virtual void * doAllocate(size_t bytes, size_t alignment) = 0;
+        virtual void doDeallocate(void *p, size_t bytes, size_t alignment) = 0;
+
+        virtual bool doIsEqual(const MemoryResource &other) const noexcept
+        {
+            return this == &other;
+        }
+    };
+
+    /**
+     * @brief Get the resource used when none is given, backed by malloc and free
+     * @return MemoryResource* The resource, it is never destroyed
+     */
+    MemoryResource * defaultMemoryResource();
+
+    /**
+     * @brief Arena that hands out memory by bumping a pointer and frees it all at once.
+     *
+     * deallocate() does nothing, memory comes back when release() is called
+     * or the arena is destroyed. Blocks are taken from the upstream resource,
+     * each one twice as large as the previous. Like its std::pmr counterpart
+     * it is not thread safe. Everything allocated from it must be destroyed
+     * before release().
+     */
+    class MonotonicBufferResource : public MemoryResource
+    {
+    public:
+        /**
+         * @brief Construct a new Monotonic Buffer Resource object
+         * @param initialSize Size of the first block taken from upstream
+         * @param upstream Source of the blocks
+         */
+        explicit MonotonicBufferResource(size_t initialSize = 4096,
+                                         MemoryResource *upstream = defaultMemoryResource());
+        /**
+         * @brief Construct an arena that starts in a caller buffer, e.g. on the stack
+         * @param buffer First block, not owned
+         * @param size Size of buffer
+         * @param upstream Source of the next blocks
+         */
+        MonotonicBufferResource(void *buffer, size_t size, MemoryResource *upstream = defaultMemoryResource());
+        ~MonotonicBufferResource();
+
+        MonotonicBufferResource(const MonotonicBufferResource &orig) = delete;
+        MonotonicBufferResource & operator=(const MonotonicBufferResource &orig) = delete;
+
+        /**
+         * @brief Give every block back to upstream, the initial buffer is reused
+         */
+        void release();
+
+    protected:
+        void * doAllocate(size_t bytes, size_t alignment) override;
+        void doDeallocate(void *p, size_t bytes, size_t alignment) override;
+
+    private:
+        struct Block
+        {
+            Block *next;
+            size_t size;
+        };
+
+        MemoryResource *upstream;
+        Block *blocks = nullptr;
+        char *initialBuffer = nullptr;
+        size_t initialBufferSize = 0;
+        char *current = nullptr;
+        size_t remaining = 0;
+        size_t nextSize;
+    };
+
+    /**
+     * @brief Standard allocator drawing from a MemoryResource, e.g. for std::allocate_shared.
+     */
+    template <typename T>
+    class ResourceAllocator
+    {
+        template <typename U> friend class ResourceAllocator;
+    public:
+        typedef T value_type;
+
+        ResourceAllocator(MemoryResource *resource = defaultMemoryResource()) noexcept : memory(resource)
+        {
+        }
+
+        template <typename U>
+        ResourceAllocator(const ResourceAllocator<U> &other) noexcept : memory(other.memory)
+        {
+        }
+
+        T * allocate(size_t n)
+        {
+            return static_cast<T *> (memory->allocate(n * sizeof (T), alignof(T)));
+        }
+
+        void deallocate(T *p, size_t n)
+        {
+            memory->deallocate(p, n * sizeof (T), alignof(T));
+        }
+
+        MemoryResource * resource() const
+        {
+            return memory;
+        }
+
+        template <typename U>
+        bool operator==(const ResourceAllocator<U> &other) const noexcept
+        {
+            return memory->isEqual(*other.memory);
+        }
+
+        template <typename U>
+        bool operator!=(const ResourceAllocator<U> &other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        MemoryResource *memory;
+    };
+}
+#endif	/* MEMORYRESOURCE_H */
@@ -0,0 +1,123 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   MpscQueue.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 3:45 PM
+ */
+
+#ifndef MPSCQUEUE_H
+#define	MPSCQUEUE_H
+#include <atomic>
+
+namespace SQLPP
+{
+    /**
+     * @brief Link of an element of an MpscQueue.
+     */
+    class _MpscNode
+    {
+        template <typename T> friend class MpscQueue;
+    private:
+        std::atomic<_MpscNode *> next{nullptr};
+    };
+
+    /**
+     * @brief Intrusive lock-free multi-producer single-consumer queue.
+     *
+     * push() is wait-free: one atomic exchange and one store. pop() must only
+     * be called from the consumer thread. It may return nullptr while a
+     * producer is in the middle of push(), the element shows up once that
+     * push completes. The queue does not own its elements.
+     * @tparam T Element type, derived from _MpscNode
+     */
+    template <typename T>
+    class MpscQueue
+    {
+    public:
+        MpscQueue() : head(&stub), tail(&stub)
+        {
+        }
+
+        MpscQueue(const MpscQueue &orig) = delete;
+        MpscQueue & operator=(const MpscQueue &orig) = delete;
+
+        /**
+         * @brief Append an element, from any thread
+         * @param element The element, it must not be in a queue
+         */
+        void push(T *element)
+        {
+            push(static_cast<_MpscNode *> (element));
+        }
+
+        /**
+         * @brief Remove the oldest element, from the consumer thread only
+         * @return T* The element, nullptr if none is available
+         */
+        T * pop()
+        {
+            _MpscNode *first = tail;
+            _MpscNode *next = first->next.load(std::memory_order_acquire);
+            if (first == &stub) {
+                if (next == nullptr) {
+                    return nullptr;
+                }
+                // Skip the stub
+                tail = next;
+                first = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+            if (next != nullptr) {
+                tail = next;
+                return static_cast<T *> (first);
+            }
+            if (first != head.load(std::memory_order_acquire)) {
+                // A producer has swapped head but not linked its node yet
+                return nullptr;
+            }
+            // first is the last element, put the stub behind it to detach it
+            push(&stub);
+            next = first->next.load(std::memory_order_acquire);
+            if (next != nullptr) {
+                tail = next;
+                return static_cast<T *> (first);
+            }
+            return nullptr;
+        }
+
+    private:
+        void push(_MpscNode *node)
+        {
+            node->next.store(nullptr, std::memory_order_relaxed);
+            _MpscNode *previous = head.exchange(node, std::memory_order_acq_rel);
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        std::atomic<_MpscNode *> head;
+        _MpscNode *tail;
+        _MpscNode stub;
+    };
+}
+#endif	/* MPSCQUEUE_H */
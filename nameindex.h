@@ -0,0 +1,160 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   NameIndex.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 7:45 PM
+ */
+
+#ifndef NAMEINDEX_H
+#define	NAMEINDEX_H
+#include "memoryresource.h"
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace SQLPP
+{
+    /**
+     * @brief Non-owning reference to a column or parameter name.
+     *
+     * Built implicitly from a string literal, a C string or a std::string, so
+     * name lookups never create a temporary std::string.
+     */
+    class NameRef
+    {
+    public:
+        NameRef(const char *name) : ptr(name), length(std::strlen(name))
+        {
+        }
+
+        NameRef(const std::string &name) : ptr(name.data()), length(name.size())
+        {
+        }
+
+        NameRef(const char *name, size_t size) : ptr(name), length(size)
+        {
+        }
+
+        const char * data() const
+        {
+            return ptr;
+        }
+
+        size_t size() const
+        {
+            return length;
+        }
+
+        std::string str() const
+        {
+            return std::string(ptr, length);
+        }
+    private:
+        const char *ptr;
+        size_t length;
+    };
+
+    /*
+     * Flat name to number index of a statement. The names are copied into
+     * one buffer and the entries are sorted by length then bytes, a lookup
+     * is a binary search comparing lengths first.
+     */
+    class _NameIndex
+    {
+    public:
+        explicit _NameIndex(MemoryResource *resource)
+        : entries(ResourceAllocator<Entry>(resource)), names(ResourceAllocator<char>(resource))
+        {
+        }
+
+        void clear()
+        {
+            entries.clear();
+            names.clear();
+        }
+
+        /* Add a name, call build() once every name is added */
+        void add(const char *name, int value)
+        {
+            Entry entry;
+            entry.offset = static_cast<uint32_t> (names.size());
+            entry.size = static_cast<uint32_t> (std::strlen(name));
+            entry.value = value;
+            names.insert(names.end(), name, name + entry.size);
+            entries.push_back(entry);
+        }
+
+        /* Sort the entries, the first added wins when a name is repeated */
+        void build()
+        {
+            // No columns or no parameters, e.g. DDL or a plain insert
+            if (entries.empty()) {
+                return;
+            }
+            std::stable_sort(entries.begin(), entries.end(), [this](const Entry &a, const Entry &b) {
+                return compare(a, b.size, names.data() + b.offset) < 0;
+            });
+        }
+
+        /* Value of a name, -1 if the name is unknown */
+        int find(const NameRef &name) const
+        {
+            auto it = std::lower_bound(entries.begin(), entries.end(), name, [this](const Entry &entry, const NameRef &key) {
+                return compare(entry, key.size(), key.data()) < 0;
+            });
+            if (it == entries.end() || compare(*it, name.size(), name.data()) != 0) {
+                return -1;
+            }
+            return it->value;
+        }
+
+        bool empty() const
+        {
+            return entries.empty();
+        }
+    private:
+        struct Entry
+        {
+            uint32_t offset;
+            uint32_t size;
+            int value;
+        };
+
+        int compare(const Entry &entry, size_t size, const char *name) const
+        {
+            if (entry.size != size) {
+                return entry.size < size ? -1 : 1;
+            }
+            return size == 0 ? 0 : std::memcmp(names.data() + entry.offset, name, size);
+        }
+
+        std::vector<Entry, ResourceAllocator<Entry> > entries;
+        std::vector<char, ResourceAllocator<char> > names;
+    };
+}
+#endif	/* NAMEINDEX_H */
@@ -0,0 +1,176 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   OpenOptions.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 5:20 PM
+ */
+
+#ifndef OPENOPTIONS_H
+#define	OPENOPTIONS_H
+#include <stdint.h>
+
+namespace SQLPP
+{
+    /**
+     * @brief SQLite threading mode of a connection.
+     */
+    enum class ThreadingMode
+    {
+        /** The mode chosen when SQLite was built or configured */
+        Default,
+        /** SQLITE_OPEN_NOMUTEX : the connection must not be used by two threads at once */
+        MultiThread,
+        /** SQLITE_OPEN_FULLMUTEX : SQLite serializes every call on the connection */
+        Serialized
+    };
+
+    /**
+     * @brief PRAGMA journal_mode values.
+     */
+    enum class JournalMode
+    {
+        /** Keep the mode of the database file */
+        Default,
+        Delete,
+        Truncate,
+        Persist,
+        Memory,
+        Wal,
+        Off
+    };
+
+    /**
+     * @brief PRAGMA synchronous values.
+     */
+    enum class Synchronous
+    {
+        /** Keep the SQLite default (FULL) */
+        Default,
+        Off,
+        Normal,
+        Full,
+        Extra
+    };
+
+    /**
+     * @brief PRAGMA temp_store values.
+     */
+    enum class TempStore
+    {
+        /** Keep the SQLite default */
+        Default,
+        File,
+        Memory
+    };
+
+    /**
+     * @brief Settings applied by Database::open(name, options).
+     *
+     * Every field left at its default value leaves the SQLite setting
+     * untouched. The pragmas are run right after the connection is opened;
+     * if one of them fails the connection is closed again and open() throws,
+     * so a Database is never left half configured.
+     */
+    struct OpenOptions
+    {
+        /** SQLITE_OPEN_READONLY instead of SQLITE_OPEN_READWRITE */
+        bool readOnly = false;
+        /** SQLITE_OPEN_CREATE, ignored when readOnly is set */
+        bool create = true;
+        /** SQLITE_OPEN_URI : the name may be a file: URI */
+        bool uri = false;
+        /** Open with the immutable=1 URI parameter : no locking, no change detection */
+        bool immutable = false;
+        /** SQLite threading mode of the connection */
+        ThreadingMode threading = ThreadingMode::Default;
+
+        /** open() throws if SQLite keeps another mode, e.g. WAL on a memory database */
+        JournalMode journalMode = JournalMode::Default;
+        Synchronous synchronous = Synchronous::Default;
+        TempStore tempStore = TempStore::Default;
+        /** PRAGMA mmap_size in bytes, negative keeps the default */
+        int64_t mmapSize = -1;
+        /** PRAGMA page_size in bytes, 0 keeps the default. Only effective on new databases */
+        int pageSize = 0;
+        /** PRAGMA cache_size, pages when positive, KiB when negative, 0 keeps the default */
+        int64_t cacheSize = 0;
+        /** sqlite3_busy_timeout in milliseconds, 0 keeps the default (fail at once) */
+        int busyTimeout = 0;
+
+        /**
+         * @brief Many small read/write transactions from several connections
+         *
+         * WAL needs a database file, open() throws on ":memory:".
+         * @return OpenOptions WAL, synchronous NORMAL, 16 MiB cache, 5 s busy timeout
+         */
+        static OpenOptions oltp()
+        {
+            OpenOptions options;
+            options.journalMode = JournalMode::Wal;
+            options.synchronous = Synchronous::Normal;
+            options.tempStore = TempStore::Memory;
+            options.cacheSize = -16 * 1024;
+            options.busyTimeout = 5000;
+            return options;
+        }
+
+        /**
+         * @brief Mostly large reads
+         *
+         * WAL needs a database file, open() throws on ":memory:".
+         * @return OpenOptions WAL, synchronous NORMAL, 256 MiB mmap, 64 MiB cache, 5 s busy timeout
+         */
+        static OpenOptions readHeavy()
+        {
+            OpenOptions options;
+            options.journalMode = JournalMode::Wal;
+            options.synchronous = Synchronous::Normal;
+            options.tempStore = TempStore::Memory;
+            options.mmapSize = 256LL * 1024 * 1024;
+            options.cacheSize = -64 * 1024;
+            options.busyTimeout = 5000;
+            return options;
+        }
+
+        /**
+         * @brief One writer loading large amounts of data
+         *
+         * The database may be corrupted by a crash or power loss during the
+         * load, only use it for data that can be loaded again.
+         * @return OpenOptions In-memory journal, synchronous OFF, 256 MiB cache
+         */
+        static OpenOptions bulkLoad()
+        {
+            OpenOptions options;
+            options.journalMode = JournalMode::Memory;
+            options.synchronous = Synchronous::Off;
+            options.tempStore = TempStore::Memory;
+            options.cacheSize = -256 * 1024;
+            options.busyTimeout = 5000;
+            return options;
+        }
+    };
+}
+#endif	/* OPENOPTIONS_H */
@@ -31,21 +31,78 @@
 #include "preparedstatement.h"
 #include "sqliteexception.h"
 #include "cursor.h"
+#include <chrono>
 
 
 namespace SQLPP
 {
-    using locker = std::lock_guard<std::recursive_mutex>;
+    using locker = HandleLock;
 
-    PreparedStatement::PreparedStatement(Database *db) : d(new _PreparedStatementData)
+    PreparedStatement::PreparedStatement(Database *db)
+    : d(makeData(db != nullptr ? db->memoryResource() : defaultMemoryResource()))
     {
         d->db = db;
+        if (db != nullptr) {
+            d->mutex.setPolicy(db->handlePolicy());
+            d->timing = db->statementTiming();
+        }
+    }
+
+    PreparedStatement::PreparedStatement(std::shared_ptr<_PreparedStatementData> data) : d(std::move(data))
+    {
+    }
+
+    std::shared_ptr<_PreparedStatementData> PreparedStatement::makeData(MemoryResource *resource)
+    {
+        // One allocation from the resource for the control block and the data
+        return std::allocate_shared<_PreparedStatementData>(ResourceAllocator<_PreparedStatementData>(resource),
+                                                            resource);
+    }
+
+    PreparedStatement::PreparedStatement(PreparedStatement &&orig) : d(std::move(orig.d))
+    {
     }
 
     PreparedStatement::~PreparedStatement()
     {
-        locker l(d->mutex);
-        finalize();
+        release();
+    }
+
+    PreparedStatement &PreparedStatement::operator=(const PreparedStatement &orig)
+    {
+        if (d != orig.d) {
+            release();
+            d = orig.d;
+        }
+        return *this;
+    }
+
+    PreparedStatement &PreparedStatement::operator=(PreparedStatement &&orig)
+    {
+        if (this != &orig) {
+            release();
+            d = std::move(orig.d);
+        }
+        return *this;
+    }
+
+    void PreparedStatement::release()
+    {
+        // Copies share the statement, only the last handle releases it
+        if (d && d.use_count() == 1) {
+            // Called from the destructor, the error of the last step was already reported
+            finalize(false);
+        }
+    }
+
+    void PreparedStatement::setHandlePolicy(HandlePolicy policy)
+    {
+        d->mutex.setPolicy(policy);
+    }
+
+    HandlePolicy PreparedStatement::handlePolicy() const
+    {
+        return d->mutex.policy();
     }
 
     void PreparedStatement::setSignalDeletion(bool value)
@@ -55,6 +112,11 @@ namespace SQLPP
     }
 
     void PreparedStatement::prepare(const std::string& sql)
+    {
+        prepare(sql, 0);
+    }
+
+    void PreparedStatement::prepare(const std::string& sql, unsigned int prepFlags)
     {
         locker l(d->mutex);
         if (d->prepared) {
@@ -64,43 +126,85 @@ namespace SQLPP
         if (d->db == nullptr) {
             throw SQLiteException(-1, "PreparedStatement::prepare : Database pointer is null");
         }
-        int result = sqlite3_prepare_v2(d->db->getSqltite3db(), sql.c_str(), sql.size() + 1, &d->stmt, nullptr);
+        int result = sqlite3_prepare_v3(d->db->getSqltite3db(), sql.c_str(), sql.size() + 1, prepFlags, &d->stmt, nullptr);
         if (result != SQLITE_OK) {
             throw SQLiteException(result, errorMsg());
         }
         // The statement is ready
         d->prepared = true;
+        d->sql = sql;
+        d->db->registerStatement(d);
         // Count columns
         int count = sqlite3_column_count(d->stmt);
 
         // Add column index and name to d->_columnsNames
-        d->columnsNames->clear();
+        d->columnsNames.clear();
+        d->rowLayouts.clear();
         for (int i = 0; i < count; i++) {
-            std::string name(sqlite3_column_name(d->stmt, i));
-            d->columnsNames->emplace(name, i);
+            d->columnsNames.add(sqlite3_column_name(d->stmt, i), i);
         }
+        d->columnsNames.build();
+
+        // Names of the parameters, anonymous ones have none
+        d->paramsNames.clear();
+        int params = sqlite3_bind_parameter_count(d->stmt);
+        for (int i = 1; i <= params; i++) {
+            const char *name = sqlite3_bind_parameter_name(d->stmt, i);
+            if (name != nullptr) {
+                d->paramsNames.add(name, i);
+            }
+        }
+        d->paramsNames.build();
 
     }
 
     void PreparedStatement::finalize()
     {
-        locker l(d->mutex);
+        finalize(true);
+    }
+
+    void PreparedStatement::finalize(bool raise)
+    {
+        // Keep the data alive until the lock is released, d may be replaced below
+        std::shared_ptr<_PreparedStatementData> data = d;
+        locker l(data->mutex);
         if (!d->prepared) {
             // Don't try to finalize unprepared statement
             return;
         }
-        if ((d->db != nullptr) && (d->stmt != nullptr)) {
-            if (sqlite3_finalize(d->stmt) != SQLITE_OK) {
-                throw SQLiteException(sqlite3_errcode(d->db->getSqltite3db()), errorMsg());
+        if (d->cached && d->db != nullptr) {
+            // Detach from the statement, the last handle (data and d here) gives it back to the cache
+            bool last = data.use_count() == 2;
+            Database *db = d->db;
+            d = makeData(data->resource);
+            d->db = db;
+            d->mutex.setPolicy(data->mutex.policy());
+            d->timing = data->timing;
+            if (last) {
+                db->recycleStatement(data);
             }
+            return;
+        }
+        if ((d->db != nullptr) && (d->stmt != nullptr)) {
+            // The statement is freed even when its last step failed
+            int result = sqlite3_finalize(d->stmt);
             d->prepared = false;
-            d->stmt == nullptr;
+            d->stmt = nullptr;
             d->excecuted = false;
+            d->bound.clear();
+            d->ownsValues = false;
+            if (result != SQLITE_OK && raise) {
+                throw SQLiteException(sqlite3_errcode(d->db->getSqltite3db()), errorMsg());
+            }
         }
     }
 
     void PreparedStatement::close()
     {
+        if (!d) {
+            // Moved-from statement
+            return;
+        }
         locker l(d->mutex);
         finalize();
     }
@@ -109,12 +213,24 @@ namespace SQLPP
     {
         locker l(d->mutex);
         if ((d->db != nullptr) && (d->stmt != nullptr)) {
-            int result = sqlite3_step(d->stmt);
-            return result;
+            return step(*d);
         }
         return SQLITE_ERROR;
     }
 
+    int PreparedStatement::step(_PreparedStatementData &data)
+    {
+        if (!data.timing) {
+            return sqlite3_step(data.stmt);
+        }
+        auto start = std::chrono::steady_clock::now();
+        int result = sqlite3_step(data.stmt);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        data.stepNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        data.timedSteps++;
+        return result;
+    }
+
     std::string PreparedStatement::errorMsg()
     {
         locker l(d->mutex);
@@ -123,18 +239,104 @@ namespace SQLPP
 
     bool PreparedStatement::isValid() const
     {
+        if (!d) {
+            return false;
+        }
         locker l(d->mutex);
         return d->prepared;
     }
 
-    int PreparedStatement::columnNumber(const std::string &name) const
+    bool PreparedStatement::isReadOnly() const
+    {
+        locker l(d->mutex);
+        if (!d->prepared) {
+            throw SQLiteException(-1, "PreparedStatement::isReadOnly - Statement is not prepared");
+        }
+        return sqlite3_stmt_readonly(d->stmt) != 0;
+    }
+
+    StatementStats PreparedStatement::stats() const
+    {
+        if (!isValid()) {
+            throw SQLiteException(-1, "PreparedStatement::stats - Statement is not prepared");
+        }
+        return collectStats(*d, false);
+    }
+
+    void PreparedStatement::resetStats()
+    {
+        if (!isValid()) {
+            throw SQLiteException(-1, "PreparedStatement::resetStats - Statement is not prepared");
+        }
+        collectStats(*d, true);
+    }
+
+    void PreparedStatement::setTiming(bool enabled)
     {
         locker l(d->mutex);
-        auto it = d->columnsNames->find(name);
-        if (it == d->columnsNames->end()) {
+        d->timing = enabled;
+    }
+
+    bool PreparedStatement::timing() const
+    {
+        locker l(d->mutex);
+        return d->timing;
+    }
+
+    StatementStats PreparedStatement::collectStats(_PreparedStatementData &data, bool reset)
+    {
+        locker l(data.mutex);
+        StatementStats stats;
+        if (!data.prepared) {
+            return stats;
+        }
+        int resetFlag = reset ? 1 : 0;
+        stats.fullscanSteps = sqlite3_stmt_status(data.stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, resetFlag);
+        stats.sorts = sqlite3_stmt_status(data.stmt, SQLITE_STMTSTATUS_SORT, resetFlag);
+        stats.autoIndexes = sqlite3_stmt_status(data.stmt, SQLITE_STMTSTATUS_AUTOINDEX, resetFlag);
+        stats.vmSteps = sqlite3_stmt_status(data.stmt, SQLITE_STMTSTATUS_VM_STEP, resetFlag);
+        stats.reprepares = sqlite3_stmt_status(data.stmt, SQLITE_STMTSTATUS_REPREPARE, resetFlag);
+        stats.runs = sqlite3_stmt_status(data.stmt, SQLITE_STMTSTATUS_RUN, resetFlag);
+        stats.memoryUsed = sqlite3_stmt_status(data.stmt, SQLITE_STMTSTATUS_MEMUSED, 0);
+        stats.timedSteps = data.timedSteps;
+        stats.stepSeconds = data.stepNanos / 1e9;
+        if (reset) {
+            data.timedSteps = 0;
+            data.stepNanos = 0;
+        }
+        return stats;
+    }
+
+    int PreparedStatement::columnNumber(NameRef name) const
+    {
+        locker l(d->mutex);
+        int column = d->columnsNames.find(name);
+        if (column < 0) {
             throw SQLiteException(-1, "PreparedStatement::columnName - Invalid column number");
         }
-        return it->second;
+        return column;
+    }
+
+    ColumnRef PreparedStatement::column(NameRef name) const
+    {
+        return ColumnRef(columnNumber(name));
+    }
+
+    ParamRef PreparedStatement::parameter(NameRef name) const
+    {
+        int index = parameterIndex(name);
+        if (index == 0) {
+            throw SQLiteException(-1, "PreparedStatement::parameter - Unknown parameter " + name.str());
+        }
+        return ParamRef(index);
+    }
+
+    int PreparedStatement::parameterIndex(NameRef name) const
+    {
+        locker l(d->mutex);
+        // Like sqlite3_bind_parameter_index, 0 for an unknown name
+        int index = d->paramsNames.find(name);
+        return index < 0 ? 0 : index;
     }
 
     void PreparedStatement::executeUpdate()
@@ -162,10 +364,9 @@ namespace SQLPP
         return c;
     }
 
-    void PreparedStatement::setInt(const std::string &paramName, int32_t value)
+    void PreparedStatement::setInt(NameRef paramName, int32_t value)
     {
-
-        setInt(sqlite3_bind_parameter_index(d->stmt, paramName.c_str()), value);
+        setInt(parameterIndex(paramName), value);
     }
 
     void PreparedStatement::setInt(int column, int32_t value)
@@ -174,13 +375,13 @@ namespace SQLPP
         if (!d->prepared) {
             return;
         }
+        d->release(column);
         sqlite3_bind_int(d->stmt, column, value);
     }
 
-    void PreparedStatement::setLong(const std::string &paramName, int64_t value)
+    void PreparedStatement::setLong(NameRef paramName, int64_t value)
     {
-
-        setLong(sqlite3_bind_parameter_index(d->stmt, paramName.c_str()), value);
+        setLong(parameterIndex(paramName), value);
     }
 
     void PreparedStatement::setLong(int column, int64_t value)
@@ -189,13 +390,13 @@ namespace SQLPP
         if (!d->prepared) {
             return;
         }
+        d->release(column);
         sqlite3_bind_int64(d->stmt, column, value);
     }
 
-    void PreparedStatement::setFloat(const std::string &paramName, float value)
+    void PreparedStatement::setFloat(NameRef paramName, float value)
     {
-
-        setFloat(sqlite3_bind_parameter_index(d->stmt, paramName.c_str()), value);
+        setFloat(parameterIndex(paramName), value);
     }
 
     void PreparedStatement::setFloat(int column, float value)
@@ -204,13 +405,13 @@ namespace SQLPP
         if (!d->prepared) {
             return;
         }
+        d->release(column);
         sqlite3_bind_double(d->stmt, column, static_cast<float> (value));
     }
 
-    void PreparedStatement::setDouble(const std::string &paramName, double value)
+    void PreparedStatement::setDouble(NameRef paramName, double value)
     {
-
-        setDouble(sqlite3_bind_parameter_index(d->stmt, paramName.c_str()), value);
+        setDouble(parameterIndex(paramName), value);
     }
 
     void PreparedStatement::setDouble(int column, double value)
@@ -219,13 +420,13 @@ namespace SQLPP
         if (!d->prepared) {
             return;
         }
+        d->release(column);
         sqlite3_bind_double(d->stmt, column, value);
     }
 
-    void PreparedStatement::setString(const std::string &paramName, const std::string &value)
+    void PreparedStatement::setString(NameRef paramName, const std::string &value)
     {
-
-        setString(sqlite3_bind_parameter_index(d->stmt, paramName.c_str()), value);
+        setString(parameterIndex(paramName), value);
     }
 
     void PreparedStatement::setString(int column, const std::string &value)
@@ -234,13 +435,33 @@ namespace SQLPP
         if (!d->prepared) {
             return;
         }
-        sqlite3_bind_text(d->stmt, column, value.c_str(), value.size() + 1, SQLITE_STATIC);
+        d->release(column);
+        sqlite3_bind_text(d->stmt, column, value.c_str(), value.size(), SQLITE_STATIC);
     }
 
-    void PreparedStatement::setBlob(const std::string &paramName, const Blob &value)
+    void PreparedStatement::setString(NameRef paramName, std::string &&value)
     {
+        setString(parameterIndex(paramName), std::move(value));
+    }
 
-        setBlob(sqlite3_bind_parameter_index(d->stmt, paramName.c_str()), value);
+    void PreparedStatement::setString(int column, std::string &&value)
+    {
+        locker l(d->mutex);
+        if (!d->prepared) {
+            return;
+        }
+        _BoundValue *slot = ownedSlot(column);
+        if (slot == nullptr) {
+            return;
+        }
+        slot->text = std::move(value);
+        slot->blob.reset();
+        sqlite3_bind_text(d->stmt, column, slot->text.c_str(), slot->text.size(), SQLITE_STATIC);
+    }
+
+    void PreparedStatement::setBlob(NameRef paramName, const Blob &value)
+    {
+        setBlob(parameterIndex(paramName), value);
     }
 
     void PreparedStatement::setBlob(int column, const Blob &value)
@@ -249,6 +470,109 @@ namespace SQLPP
         if (!d->prepared) {
             return;
         }
+        _BoundValue *slot = ownedSlot(column);
+        if (slot == nullptr) {
+            return;
+        }
+        // The reference keeps the data alive as long as SQLite points to it
+        slot->text = std::string();
+        slot->blob = value.d;
         sqlite3_bind_blob(d->stmt, column, value.data(), value.size(), SQLITE_STATIC);
     }
+
+    void PreparedStatement::clearBindings()
+    {
+        locker l(d->mutex);
+        if (!d->prepared) {
+            return;
+        }
+        d->clearBindings();
+    }
+
+    _BoundValue * PreparedStatement::ownedSlot(int column)
+    {
+        if (column < 1 || column > sqlite3_bind_parameter_count(d->stmt)) {
+            // Out of range, let SQLite report it like for the other binds
+            sqlite3_bind_null(d->stmt, column);
+            return nullptr;
+        }
+        if (d->bound.size() <= static_cast<size_t> (column)) {
+            d->bound.resize(sqlite3_bind_parameter_count(d->stmt) + 1);
+        }
+        d->ownsValues = true;
+        return &d->bound[column];
+    }
+
+    void PreparedStatement::setZeroBlob(NameRef paramName, int64_t size)
+    {
+        setZeroBlob(parameterIndex(paramName), size);
+    }
+
+    void PreparedStatement::setZeroBlob(int column, int64_t size)
+    {
+        locker l(d->mutex);
+        if (!d->prepared) {
+            return;
+        }
+        d->release(column);
+        int result = sqlite3_bind_zeroblob64(d->stmt, column, static_cast<sqlite3_uint64> (size));
+        if (result != SQLITE_OK) {
+            throw SQLiteException(result, errorMsg());
+        }
+    }
+
+    BatchResult PreparedStatement::executeMany(const RowProducer &producer, const BatchOptions &options)
+    {
+        locker l(d->mutex);
+        if (!d->prepared) {
+            throw SQLiteException(-1, "PreparedStatement::executeMany - Statement is not prepared");
+        }
+        if (!d->cursorClosed) {
+            throw SQLiteException(-1, "Current Cursor must be closed before executing prepared statement");
+        }
+
+        BatchResult result;
+        auto start = std::chrono::steady_clock::now();
+        bool ownTransaction = options.transaction && sqlite3_get_autocommit(d->db->getSqltite3db());
+        size_t pending = 0;
+        sqlite3_reset(d->stmt);
+        try {
+            if (ownTransaction) {
+                d->db->begin();
+            }
+            while (producer(*this)) {
+                int rc = step(*d);
+                if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+                    SQLiteException e(rc, errorMsg());
+                    sqlite3_reset(d->stmt);
+                    d->clearBindings();
+                    throw e;
+                }
+                sqlite3_reset(d->stmt);
+                d->clearBindings();
+                result.rows++;
+                if (ownTransaction && options.commitEvery > 0 && ++pending == options.commitEvery) {
+                    d->db->commit();
+                    d->db->begin();
+                    pending = 0;
+                }
+            }
+            if (ownTransaction) {
+                d->db->commit();
+            }
+        }
+        catch (...) {
+            if (ownTransaction && !sqlite3_get_autocommit(d->db->getSqltite3db())) {
+                try {
+                    d->db->rollback();
+                }
+                catch (...) {
+                    // Keep the original error
+                }
+            }
+            throw;
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
 }
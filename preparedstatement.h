@@ -31,36 +31,151 @@
 #define PREPAREDSTATEMENT_H
 #include "blob.h"
 #include "database.hpp"
+#include "handlepolicy.h"
+#include "memoryresource.h"
+#include "nameindex.h"
+#include "statementstats.h"
+#include "tuplebinder.h"
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
 #include <sqlite3.h>
 #include <string>
-#include <unordered_map>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace SQLPP {
+class BulkLoader;
 class Cursor;
 class PreparedStatement;
+template <typename Row> class TypedQuery;
+
+/**
+ * @brief Options of PreparedStatement::executeMany
+ */
+struct BatchOptions {
+  /** Run the rows inside an implicit transaction when none is open */
+  bool transaction = true;
+  /** Commit the implicit transaction every commitEvery rows, 0 commits once */
+  size_t commitEvery = 0;
+};
+
+/**
+ * @brief Outcome of PreparedStatement::executeMany
+ */
+struct BatchResult {
+  /** Number of rows executed */
+  uint64_t rows = 0;
+  /** Wall time spent in executeMany, including commits */
+  double seconds = 0;
+
+  double rowsPerSecond() const { return seconds > 0 ? rows / seconds : 0; }
+};
+
+/**
+ * @brief Column number resolved once with PreparedStatement::column()
+ *
+ * It converts to the column index, so it is accepted by every Cursor getter
+ * taking an index. It is only meaningful for the statement it comes from.
+ */
+struct ColumnRef {
+  ColumnRef() : index(-1) {}
+  explicit ColumnRef(int index) : index(index) {}
+
+  operator int() const { return index; }
+
+  int index;
+};
+
+/**
+ * @brief Parameter number resolved once with PreparedStatement::parameter()
+ *
+ * It converts to the parameter index, so it is accepted by every setter
+ * taking an index. It is only meaningful for the statement it comes from.
+ */
+struct ParamRef {
+  ParamRef() : index(0) {}
+  explicit ParamRef(int index) : index(index) {}
+
+  operator int() const { return index; }
+
+  int index;
+};
+
+/* Value owned by a statement for one of its parameters */
+struct _BoundValue {
+  std::string text;
+  std::shared_ptr<_BlobData> blob;
+};
 
 class _PreparedStatementData {
   friend PreparedStatement;
   friend Cursor;
+  friend Database;
+  friend StatementCache;
+  friend BulkLoader;
+  template <typename Row> friend class TypedQuery;
 
 public:
-  _PreparedStatementData() {
-    columnsNames = new std::unordered_map<std::string, int>();
-  }
+  explicit _PreparedStatementData(MemoryResource *resource)
+      : columnsNames(resource), paramsNames(resource), resource(resource) {}
 
-  ~_PreparedStatementData() { delete columnsNames; }
+  /* Handles finalize or recycle the statement, this only catches data
+     outliving them, e.g. held by Database::statementStats() */
+  ~_PreparedStatementData() {
+    if (stmt != nullptr) {
+      sqlite3_finalize(stmt);
+    }
+  }
 
 private:
+  /* Forget the value owned for a parameter that is bound again */
+  void release(int column) {
+    if (ownsValues && column > 0 && static_cast<size_t>(column) < bound.size()) {
+      bound[column].text = std::string();
+      bound[column].blob.reset();
+    }
+  }
+
+  /* Clear the SQLite bindings and the values owned for them */
+  void clearBindings() {
+    sqlite3_clear_bindings(stmt);
+    if (ownsValues) {
+      bound.clear();
+      ownsValues = false;
+    }
+  }
+
   sqlite3_stmt *stmt = 0;
   bool signalDeletion = true;
   bool prepared = false;
   bool excecuted = false;
   bool cursorClosed = true;
-  std::recursive_mutex mutex;
-  std::unordered_map<std::string, int> *columnsNames;
+  HandleMutex mutex;
+  // Column numbers by name, built in prepare()
+  _NameIndex columnsNames;
+  // Parameter numbers by name, built in prepare()
+  _NameIndex paramsNames;
   Database *db;
+  // Statement cache bookkeeping
+  bool cached = false;
+  uint64_t cacheGeneration = 0;
+  std::string sql;
+  // Wall time of the steps, collected when timing is enabled
+  bool timing = false;
+  uint64_t timedSteps = 0;
+  uint64_t stepNanos = 0;
+  // Source of the memory of this object and of its cursors
+  MemoryResource *resource;
+  // Strings and Blobs bound with ownership, by parameter index
+  std::vector<_BoundValue> bound;
+  bool ownsValues = false;
+  // Columns of the SQLPP_FIELDS structs read from the statement, by struct
+  std::vector<std::pair<const void *, std::vector<int>>> rowLayouts;
 };
 
 /**
@@ -73,6 +188,8 @@ private:
 class PreparedStatement {
   friend Database;
   friend Cursor;
+  friend BulkLoader;
+  template <typename Row> friend class TypedQuery;
 
 public:
   /**
@@ -80,10 +197,39 @@ public:
    * @param db Pointer to the Database object
    */
   PreparedStatement(Database *db);
+  /**
+   * @brief Copy constructor, both objects share the same statement
+   * @param orig Original object
+   */
+  PreparedStatement(const PreparedStatement &orig) = default;
+  /**
+   * @brief Move constructor, orig no longer refers to a statement
+   *
+   * A moved-from statement reports isValid() false and close() does nothing.
+   * @param orig Original object
+   */
+  PreparedStatement(PreparedStatement &&orig);
   /**
    * @brief Destroy the Prepared Statement object
+   *
+   * The statement is finalized (or given back to the statement cache) when
+   * its last handle is destroyed.
    */
   virtual ~PreparedStatement();
+  PreparedStatement &operator=(const PreparedStatement &orig);
+  PreparedStatement &operator=(PreparedStatement &&orig);
+
+  /**
+   * @brief Set the locking policy of the statement and of its cursors
+   * @param policy HandlePolicy::SingleThread removes all locking
+   * @note Must be set before the statement is shared between threads
+   */
+  void setHandlePolicy(HandlePolicy policy);
+  /**
+   * @brief Get the locking policy of the statement
+   * @return HandlePolicy The policy
+   */
+  HandlePolicy handlePolicy() const;
 
   /**
    * @brief Prepare a new SQL statement
@@ -110,23 +256,76 @@ public:
    * @return true if valid, false otherwise
    */
   bool isValid() const;
+  /**
+   * @brief Check if the statement makes no direct change to the database
+   * @return true if the statement is read-only (sqlite3_stmt_readonly)
+   */
+  bool isReadOnly() const;
+
+  /**
+   * @brief Get the runtime counters of the statement
+   *
+   * The sqlite3_stmt_status counters tell which statements run full scans,
+   * sorts or build automatic indexes. The wall time is only collected while
+   * timing is enabled.
+   * @return StatementStats The counters
+   * @throw SQLiteException if the statement is not prepared
+   */
+  StatementStats stats() const;
+  /**
+   * @brief Reset the runtime counters of the statement, except memoryUsed
+   * @throw SQLiteException if the statement is not prepared
+   */
+  void resetStats();
+  /**
+   * @brief Measure the wall time spent stepping the statement
+   *
+   * The initial value is Database::statementTiming().
+   * @param enabled true to time every sqlite3_step call
+   */
+  void setTiming(bool enabled);
+  /**
+   * @brief Check if the statement measures the time spent stepping
+   * @return true if timing is enabled
+   */
+  bool timing() const;
 
   /**
    * @brief Close the statement and free resources
+   *
+   * A statement from the statement cache goes back to the cache when this
+   * is its last handle, otherwise only this handle is detached from it.
+   * The destructor releases the statement the same way without throwing.
+   * @throw SQLiteException if sqlite3_finalize reports an error
    */
   void close();
   /**
    * @brief Get the index of a column by its name
    * @param name Name of the column
    * @return int Index of the column
+   * @throw SQLiteException if there is no such column
    */
-  int columnNumber(const std::string &name) const;
+  int columnNumber(NameRef name) const;
+  /**
+   * @brief Resolve a column name once, for repeated reads by index
+   * @param name Name of the column
+   * @return ColumnRef Handle on the column
+   * @throw SQLiteException if there is no such column
+   */
+  ColumnRef column(NameRef name) const;
+  /**
+   * @brief Resolve a parameter name once, for repeated binds by index
+   * @param name Name of the parameter, with its prefix (e.g., ":id")
+   * @return ParamRef Handle accepted by every setter taking an index
+   * @throw SQLiteException if there is no such parameter
+   */
+  ParamRef parameter(NameRef name) const;
   /**
    * @brief Bind an integer value to a named parameter
    * @param paramName Name of the parameter (e.g., ":id")
    * @param value Integer value to bind
    */
-  void setInt(const std::string &paramName, int32_t value);
+  void setInt(NameRef paramName, int32_t value);
   /**
    * @brief Bind an integer value to a parameter by index
    * @param column Index of the parameter (1-based)
@@ -138,7 +337,7 @@ public:
    * @param paramName Name of the parameter
    * @param value Long value to bind
    */
-  void setLong(const std::string &paramName, int64_t value);
+  void setLong(NameRef paramName, int64_t value);
   /**
    * @brief Bind a long value to a parameter by index
    * @param column Index of the parameter (1-based)
@@ -150,7 +349,7 @@ public:
    * @param paramName Name of the parameter
    * @param value Float value to bind
    */
-  void setFloat(const std::string &paramName, float value);
+  void setFloat(NameRef paramName, float value);
   /**
    * @brief Bind a float value to a parameter by index
    * @param column Index of the parameter (1-based)
@@ -162,7 +361,7 @@ public:
    * @param paramName Name of the parameter
    * @param value Double value to bind
    */
-  void setDouble(const std::string &paramName, double value);
+  void setDouble(NameRef paramName, double value);
   /**
    * @brief Bind a double value to a parameter by index
    * @param column Index of the parameter (1-based)
@@ -171,30 +370,138 @@ public:
   void setDouble(int column, double value);
   /**
    * @brief Bind a string value to a named parameter
+   *
+   * The string is not copied, it must stay alive until the statement has
+   * run or the parameter is bound again.
    * @param paramName Name of the parameter
    * @param value String value to bind
    */
-  void setString(const std::string &paramName, const std::string &value);
+  void setString(NameRef paramName, const std::string &value);
   /**
    * @brief Bind a string value to a parameter by index
+   *
+   * The string is not copied, it must stay alive until the statement has
+   * run or the parameter is bound again.
    * @param column Index of the parameter (1-based)
    * @param value String value to bind
    */
   void setString(int column, const std::string &value);
+  /**
+   * @brief Bind a string moved into the statement to a named parameter
+   *
+   * The statement owns the string until the parameter is bound again, the
+   * bindings are cleared or the statement is closed. Temporaries and string
+   * literals are safe to bind this way, without copying the text.
+   * @param paramName Name of the parameter
+   * @param value String value to bind
+   */
+  void setString(NameRef paramName, std::string &&value);
+  /**
+   * @brief Bind a string moved into the statement to a parameter by index
+   * @param column Index of the parameter (1-based)
+   * @param value String value to bind
+   */
+  void setString(int column, std::string &&value);
   /**
    * @brief Bind a Blob value to a named parameter
+   *
+   * The statement keeps a reference on the data until the parameter is
+   * bound again, the bindings are cleared or the statement is closed.
    * @param paramName Name of the parameter
    * @param value Blob value to bind
    */
-  void setBlob(const std::string &paramName, const Blob &value);
+  void setBlob(NameRef paramName, const Blob &value);
   /**
    * @brief Bind a Blob value to a parameter by index
    * @param column Index of the parameter (1-based)
    * @param value Blob value to bind
    */
   void setBlob(int column, const Blob &value);
+  /**
+   * @brief Bind a blob of size zero bytes to a named parameter
+   *
+   * The space is preallocated without any buffer, fill it with a BlobStream.
+   * @param paramName Name of the parameter
+   * @param size Size of the blob in bytes
+   */
+  void setZeroBlob(NameRef paramName, int64_t size);
+  /**
+   * @brief Bind a blob of size zero bytes to a parameter by index
+   * @param column Index of the parameter (1-based)
+   * @param size Size of the blob in bytes
+   */
+  void setZeroBlob(int column, int64_t size);
+
+  /**
+   * @brief Reset every parameter to NULL and release the values the statement owns
+   */
+  void clearBindings();
+
+  /**
+   * @brief Callback binding the next row, returns false when there is no more row
+   */
+  using RowProducer = std::function<bool(PreparedStatement &)>;
+
+  /**
+   * @brief Execute the statement once per row given by producer
+   *
+   * Binding, stepping, reset and clear bindings run in one tight loop under
+   * a single lock. With options.transaction and no open transaction, the rows
+   * run inside an implicit transaction, rolled back on error.
+   * @param producer Binds the parameters of the next row with setXxx()
+   * @param options Transaction options
+   * @return BatchResult Number of rows and rows per second
+   * @throw SQLiteException on error
+   */
+  BatchResult executeMany(const RowProducer &producer,
+                          const BatchOptions &options = BatchOptions());
+
+  /**
+   * @brief Execute the statement once per tuple of rows
+   *
+   * Tuple members are bound to parameters 1..N. When the range is a
+   * forward range of stored tuples, strings and Blobs are bound without
+   * copy and must stay alive during the call. Tuples produced on the fly
+   * (an iterator returning by value, or an input iterator) are copied by
+   * SQLite, since they are gone when the row runs.
+   * @param rows Range of std::tuple (integers, floating point, std::string,
+   * const char *, Blob or nullptr)
+   * @param options Transaction options
+   * @return BatchResult Number of rows and rows per second
+   * @throw SQLiteException on error
+   */
+  template <typename Range,
+            typename = decltype(std::begin(std::declval<const Range &>()))>
+  BatchResult executeMany(const Range &rows,
+                          const BatchOptions &options = BatchOptions()) {
+    auto it = std::begin(rows);
+    auto end = std::end(rows);
+    typedef decltype(it) Iterator;
+    // The row steps after ++it, only a reference into a forward range is still valid
+    const bool stored =
+        std::is_lvalue_reference<decltype(*it)>::value &&
+        std::is_base_of<
+            std::forward_iterator_tag,
+            typename std::iterator_traits<Iterator>::iterator_category>::value;
+    sqlite3_destructor_type lifetime = stored ? SQLITE_STATIC : SQLITE_TRANSIENT;
+    return executeMany(RowProducer([&](PreparedStatement &stmt) {
+                         if (it == end) {
+                           return false;
+                         }
+                         _TupleBinder::bind(stmt.d->stmt, *it, lifetime);
+                         ++it;
+                         return true;
+                       }),
+                       options);
+  }
 
 protected:
+  /**
+   * @brief Prepare a new SQL statement with sqlite3_prepare_v3 flags
+   * @param sql The SQL query string
+   * @param prepFlags SQLITE_PREPARE_* flags
+   */
+  void prepare(const std::string &sql, unsigned int prepFlags);
   /**
    *
    * @param value
@@ -209,8 +516,25 @@ protected:
    * @return
    */
   int next();
+  /**
+   * Finalize the statement if this is the last handle on it. Does not throw
+   * when sqlite3_finalize reports the error of the last step, the statement
+   * is freed anyway
+   */
+  void release();
 
 private:
+  /* Handle on existing data, e.g. a statement taken from the cache */
+  explicit PreparedStatement(std::shared_ptr<_PreparedStatementData> data);
+  static std::shared_ptr<_PreparedStatementData>
+  makeData(MemoryResource *resource);
+  /* raise false ignores the result of sqlite3_finalize */
+  void finalize(bool raise);
+  static int step(_PreparedStatementData &data);
+  int parameterIndex(NameRef name) const;
+  _BoundValue *ownedSlot(int column);
+  static StatementStats collectStats(_PreparedStatementData &data, bool reset);
+
   std::shared_ptr<_PreparedStatementData> d;
 };
 } // namespace SQLPP
@@ -0,0 +1,160 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   RowMapping.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 7:10 PM
+ */
+
+#ifndef ROWMAPPING_H
+#define	ROWMAPPING_H
+#include "columnreader.h"
+#include <sqlite3.h>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace SQLPP
+{
+    /**
+     * @brief Fields of a struct read from query rows, declared with SQLPP_FIELDS.
+     *
+     * names() gives the column name of each field (the field name) and
+     * members() the matching pointers to members.
+     */
+    template <typename T>
+    struct RowMapping;
+
+    /* Number of fields of a mapped struct */
+    template <typename T>
+    struct _RowFieldCount
+    {
+        static const size_t value = std::tuple_size<decltype(RowMapping<T>::members())>::value;
+    };
+
+    /* Identifies a mapped struct in the per statement column layouts */
+    template <typename T>
+    const void * _rowMappingKey()
+    {
+        static const char key = 0;
+        return &key;
+    }
+
+    /* Decodes fields I..N-1 of a mapped struct from their resolved columns */
+    template <size_t I, size_t N>
+    struct _FieldDecoder
+    {
+        template <typename T, typename Members>
+        static void decode(sqlite3_stmt *stmt, const int *columns, const Members &members, T &row)
+        {
+            typedef typename std::remove_reference<decltype(row.*std::get<I>(members))>::type Type;
+            row.*std::get<I>(members) = _ColumnReader<Type>::read(stmt, columns[I]);
+            _FieldDecoder<I + 1, N>::decode(stmt, columns, members, row);
+        }
+    };
+
+    template <size_t N>
+    struct _FieldDecoder<N, N>
+    {
+        template <typename T, typename Members>
+        static void decode(sqlite3_stmt *, const int *, const Members &, T &)
+        {
+        }
+    };
+}
+
+/* Applies M(Type, field) to each field, separated by commas (up to 32 fields) */
+#define _SQLPP_EXPAND(x) x
+#define _SQLPP_CAT(a, b) _SQLPP_CAT_(a, b)
+#define _SQLPP_CAT_(a, b) a##b
+#define _SQLPP_COUNT(...) _SQLPP_EXPAND(_SQLPP_COUNT_N(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define _SQLPP_COUNT_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, N, ...) N
+#define _SQLPP_FOR_EACH(M, Type, ...) _SQLPP_EXPAND(_SQLPP_CAT(_SQLPP_FOR_EACH_, _SQLPP_COUNT(__VA_ARGS__))(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_1(M, Type, field) M(Type, field)
+#define _SQLPP_FOR_EACH_2(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_1(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_3(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_2(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_4(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_3(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_5(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_4(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_6(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_5(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_7(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_6(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_8(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_7(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_9(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_8(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_10(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_9(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_11(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_10(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_12(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_11(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_13(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_12(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_14(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_13(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_15(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_14(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_16(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_15(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_17(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_16(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_18(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_17(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_19(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_18(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_20(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_19(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_21(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_20(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_22(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_21(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_23(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_22(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_24(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_23(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_25(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_24(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_26(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_25(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_27(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_26(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_28(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_27(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_29(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_28(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_30(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_29(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_31(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_30(M, Type, __VA_ARGS__))
+#define _SQLPP_FOR_EACH_32(M, Type, field, ...) M(Type, field), _SQLPP_EXPAND(_SQLPP_FOR_EACH_31(M, Type, __VA_ARGS__))
+#define _SQLPP_FIELD_NAME(Type, field) #field
+#define _SQLPP_FIELD_MEMBER(Type, field) &Type::field
+
+/**
+ * @brief Map the fields of a struct to the columns of the same name
+ *
+ * Use it at global scope, after the struct definition. Cursor::read<Type>()
+ * and Cursor::readAll() then resolve the column of each field once per
+ * statement and decode every row by index. Fields can be integers, floating
+ * point, std::string, Blob or std::vector<char>.
+ *
+ * @code
+ * struct User { int64_t id; std::string name; double score; };
+ * SQLPP_FIELDS(User, id, name, score)
+ * @endcode
+ */
+#define SQLPP_FIELDS(Type, ...) \
+    namespace SQLPP \
+    { \
+        template <> \
+        struct RowMapping<Type> \
+        { \
+            static const char * const * names() \
+            { \
+                static const char * const fieldNames[] = { _SQLPP_FOR_EACH(_SQLPP_FIELD_NAME, Type, __VA_ARGS__) }; \
+                return fieldNames; \
+            } \
+            static decltype(std::make_tuple(_SQLPP_FOR_EACH(_SQLPP_FIELD_MEMBER, Type, __VA_ARGS__))) members() \
+            { \
+                return std::make_tuple(_SQLPP_FOR_EACH(_SQLPP_FIELD_MEMBER, Type, __VA_ARGS__)); \
+            } \
+        }; \
+    }
+
+#endif	/* ROWMAPPING_H */
@@ -0,0 +1,404 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   SQLiteAllocator.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 6:30 PM
+ */
+
+#include "sqliteallocator.h"
+#include "sqliteexception.h"
+#include <sqlite3.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace SQLPP
+{
+    namespace
+    {
+        /* Size classes 16, 32, ... 32768, then one slot for the large allocations */
+        const int CLASS_COUNT = 12;
+        const int LARGE = CLASS_COUNT;
+        const size_t MIN_BLOCK = 16;
+        const size_t MAX_BLOCK = MIN_BLOCK << (CLASS_COUNT - 1);
+        /* Every block starts with its usable size, SQLite needs 8 byte alignment */
+        const size_t HEADER = 8;
+        const int64_t PUBLISH_BYTES = 64 * 1024;
+
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        struct Counters
+        {
+            std::atomic<uint64_t> allocations[CLASS_COUNT + 1];
+            std::atomic<uint64_t> frees[CLASS_COUNT + 1];
+
+            Counters()
+            {
+                for (int i = 0; i <= CLASS_COUNT; i++) {
+                    allocations[i] = 0;
+                    frees[i] = 0;
+                }
+            }
+        };
+
+        struct SharedPool
+        {
+            std::mutex mutex;
+            FreeBlock *blocks = nullptr;
+            size_t count = 0;
+        };
+
+        struct ThreadCache;
+
+        struct Allocator
+        {
+            AllocatorOptions options;
+            SharedPool pools[CLASS_COUNT];
+            std::atomic<int64_t> liveBytes{0};
+            std::atomic<int64_t> peakBytes{0};
+            /* Counters of the threads that have exited, and of the calls made without a cache */
+            Counters retired;
+            std::mutex threadsMutex;
+            std::vector<ThreadCache *> threads;
+        };
+
+        /* Never destroyed, SQLite may free memory during static destruction */
+        Allocator *allocator = nullptr;
+        std::atomic<bool> configured(false);
+
+        void publish(int64_t bytes)
+        {
+            int64_t live = allocator->liveBytes.fetch_add(bytes) + bytes;
+            int64_t peak = allocator->peakBytes.load();
+            while (live > peak && !allocator->peakBytes.compare_exchange_weak(peak, live)) {
+            }
+        }
+
+        struct ThreadCache
+        {
+            FreeBlock *blocks[CLASS_COUNT];
+            size_t counts[CLASS_COUNT];
+            Counters counters;
+            /* Bytes allocated minus bytes freed, not yet added to liveBytes */
+            int64_t balance = 0;
+
+            ThreadCache()
+            {
+                for (int i = 0; i < CLASS_COUNT; i++) {
+                    blocks[i] = nullptr;
+                    counts[i] = 0;
+                }
+                std::lock_guard<std::mutex> l(allocator->threadsMutex);
+                allocator->threads.push_back(this);
+            }
+
+            ~ThreadCache()
+            {
+                for (int i = 0; i < CLASS_COUNT; i++) {
+                    giveBack(i, counts[i]);
+                }
+                publish(balance);
+                std::lock_guard<std::mutex> l(allocator->threadsMutex);
+                for (int i = 0; i <= CLASS_COUNT; i++) {
+                    allocator->retired.allocations[i] += counters.allocations[i].load();
+                    allocator->retired.frees[i] += counters.frees[i].load();
+                }
+                for (size_t i = 0; i < allocator->threads.size(); i++) {
+                    if (allocator->threads[i] == this) {
+                        allocator->threads.erase(allocator->threads.begin() + i);
+                        break;
+                    }
+                }
+            }
+
+            void account(int64_t bytes)
+            {
+                balance += bytes;
+                if (balance >= PUBLISH_BYTES || balance <= -PUBLISH_BYTES) {
+                    publish(balance);
+                    balance = 0;
+                }
+            }
+
+            /* Move n blocks of class c to the shared pool */
+            void giveBack(int c, size_t n)
+            {
+                if (n == 0) {
+                    return;
+                }
+                FreeBlock *first = blocks[c];
+                FreeBlock *last = first;
+                for (size_t i = 1; i < n; i++) {
+                    last = last->next;
+                }
+                blocks[c] = last->next;
+                counts[c] -= n;
+                SharedPool &pool = allocator->pools[c];
+                std::lock_guard<std::mutex> l(pool.mutex);
+                last->next = pool.blocks;
+                pool.blocks = first;
+                pool.count += n;
+            }
+
+            /* Take up to n blocks of class c from the shared pool */
+            void refill(int c, size_t n)
+            {
+                SharedPool &pool = allocator->pools[c];
+                std::lock_guard<std::mutex> l(pool.mutex);
+                while (n > 0 && pool.blocks != nullptr) {
+                    FreeBlock *block = pool.blocks;
+                    pool.blocks = block->next;
+                    pool.count--;
+                    block->next = blocks[c];
+                    blocks[c] = block;
+                    counts[c]++;
+                    n--;
+                }
+            }
+        };
+
+        /*
+         * The cache is reached through a trivial pointer : SQLite may allocate
+         * or free while the thread_local objects of the thread are destroyed.
+         */
+        thread_local ThreadCache *threadCache = nullptr;
+        thread_local bool threadCacheDestroyed = false;
+
+        struct ThreadCacheOwner
+        {
+            ThreadCache cache;
+
+            ThreadCacheOwner()
+            {
+                threadCache = &cache;
+            }
+
+            ~ThreadCacheOwner()
+            {
+                threadCache = nullptr;
+                threadCacheDestroyed = true;
+            }
+        };
+
+        ThreadCache * currentCache()
+        {
+            if (threadCache == nullptr && !threadCacheDestroyed) {
+                thread_local ThreadCacheOwner owner;
+            }
+            return threadCache;
+        }
+
+        int sizeClass(size_t size)
+        {
+            if (size > MAX_BLOCK) {
+                return LARGE;
+            }
+            int c = 0;
+            size_t block = MIN_BLOCK;
+            while (block < size) {
+                block <<= 1;
+                c++;
+            }
+            return c;
+        }
+
+        size_t blockSize(int c)
+        {
+            return MIN_BLOCK << c;
+        }
+
+        int roundUp(int size)
+        {
+            size_t n = size > 0 ? static_cast<size_t> (size) : 1;
+            int c = sizeClass(n);
+            if (c == LARGE) {
+                return static_cast<int> ((n + 7) & ~static_cast<size_t> (7));
+            }
+            return static_cast<int> (blockSize(c));
+        }
+
+        void * xMalloc(int requested)
+        {
+            size_t size = static_cast<size_t> (roundUp(requested));
+            int c = sizeClass(size);
+            ThreadCache *cache = currentCache();
+            char *block = nullptr;
+            if (c != LARGE && cache != nullptr) {
+                if (cache->blocks[c] == nullptr) {
+                    cache->refill(c, allocator->options.transferBlocks);
+                }
+                if (cache->blocks[c] != nullptr) {
+                    FreeBlock *free = cache->blocks[c];
+                    cache->blocks[c] = free->next;
+                    cache->counts[c]--;
+                    block = reinterpret_cast<char *> (free) - HEADER;
+                }
+            }
+            if (block == nullptr) {
+                block = static_cast<char *> (::malloc(HEADER + size));
+                if (block == nullptr) {
+                    return nullptr;
+                }
+                *reinterpret_cast<uint64_t *> (block) = size;
+            }
+            if (cache != nullptr) {
+                cache->counters.allocations[c].fetch_add(1, std::memory_order_relaxed);
+                cache->account(static_cast<int64_t> (size));
+            } else {
+                allocator->retired.allocations[c]++;
+                publish(static_cast<int64_t> (size));
+            }
+            return block + HEADER;
+        }
+
+        void xFree(void *p)
+        {
+            if (p == nullptr) {
+                return;
+            }
+            char *block = static_cast<char *> (p) - HEADER;
+            size_t size = static_cast<size_t> (*reinterpret_cast<uint64_t *> (block));
+            int c = sizeClass(size);
+            ThreadCache *cache = currentCache();
+            if (cache == nullptr) {
+                allocator->retired.frees[c]++;
+                publish(-static_cast<int64_t> (size));
+                ::free(block);
+                return;
+            }
+            cache->counters.frees[c].fetch_add(1, std::memory_order_relaxed);
+            cache->account(-static_cast<int64_t> (size));
+            if (c == LARGE) {
+                ::free(block);
+                return;
+            }
+            // Cached blocks keep their size header, the link lives in the user part
+            FreeBlock *free = reinterpret_cast<FreeBlock *> (block + HEADER);
+            free->next = cache->blocks[c];
+            cache->blocks[c] = free;
+            cache->counts[c]++;
+            if (cache->counts[c] > allocator->options.threadCacheBlocks) {
+                cache->giveBack(c, allocator->options.transferBlocks);
+            }
+        }
+
+        int xSize(void *p)
+        {
+            if (p == nullptr) {
+                return 0;
+            }
+            return static_cast<int> (*reinterpret_cast<uint64_t *> (static_cast<char *> (p) - HEADER));
+        }
+
+        void * xRealloc(void *p, int requested)
+        {
+            int old = xSize(p);
+            if (roundUp(requested) == old) {
+                return p;
+            }
+            void *moved = xMalloc(requested);
+            if (moved == nullptr) {
+                return nullptr;
+            }
+            ::memcpy(moved, p, old < requested ? old : requested);
+            xFree(p);
+            return moved;
+        }
+
+        int xRoundup(int size)
+        {
+            return roundUp(size);
+        }
+
+        int xInit(void *)
+        {
+            return SQLITE_OK;
+        }
+
+        void xShutdown(void *)
+        {
+        }
+    }
+
+    void configureAllocator(const AllocatorOptions &options)
+    {
+        static std::mutex configureMutex;
+        std::lock_guard<std::mutex> l(configureMutex);
+        if (configured) {
+            throw SQLiteException(SQLITE_MISUSE, "configureAllocator - The allocator is already installed");
+        }
+        if (allocator == nullptr) {
+            allocator = new Allocator;
+        }
+        allocator->options = options;
+        if (allocator->options.transferBlocks == 0) {
+            allocator->options.transferBlocks = 1;
+        }
+
+        static sqlite3_mem_methods methods = {
+            xMalloc, xFree, xRealloc, xSize, xRoundup, xInit, xShutdown, nullptr
+        };
+        int result = sqlite3_config(SQLITE_CONFIG_MALLOC, &methods);
+        if (result != SQLITE_OK) {
+            throw SQLiteException(result, "configureAllocator - SQLite is already initialized, "
+                                  "call it before opening any connection");
+        }
+        configured = true;
+    }
+
+    bool allocatorConfigured()
+    {
+        return configured;
+    }
+
+    AllocatorStats allocatorStats()
+    {
+        AllocatorStats stats;
+        if (!configured) {
+            return stats;
+        }
+        stats.sizeClasses.resize(CLASS_COUNT + 1);
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            stats.sizeClasses[c].blockSize = blockSize(c);
+        }
+        std::lock_guard<std::mutex> l(allocator->threadsMutex);
+        for (int c = 0; c <= CLASS_COUNT; c++) {
+            stats.sizeClasses[c].allocations = allocator->retired.allocations[c].load();
+            stats.sizeClasses[c].frees = allocator->retired.frees[c].load();
+            for (ThreadCache *cache : allocator->threads) {
+                stats.sizeClasses[c].allocations += cache->counters.allocations[c].load(std::memory_order_relaxed);
+                stats.sizeClasses[c].frees += cache->counters.frees[c].load(std::memory_order_relaxed);
+            }
+        }
+        int64_t live = allocator->liveBytes.load();
+        stats.liveBytes = live > 0 ? static_cast<uint64_t> (live) : 0;
+        stats.peakBytes = static_cast<uint64_t> (allocator->peakBytes.load());
+        return stats;
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   SQLiteAllocator.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 6:30 PM
+ */
+
+#ifndef SQLITEALLOCATOR_H
+#define	SQLITEALLOCATOR_H
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace SQLPP
+{
+    /**
+     * @brief Options of configureAllocator.
+     */
+    struct AllocatorOptions
+    {
+        /** Maximum number of free blocks kept by each thread for each size class */
+        size_t threadCacheBlocks = 256;
+        /** Blocks moved at once between a thread cache and the shared pool */
+        size_t transferBlocks = 32;
+    };
+
+    /**
+     * @brief Activity of one size class of the allocator.
+     */
+    struct SizeClassStats
+    {
+        /** Size of the blocks of the class, 0 for the allocations larger than every class */
+        size_t blockSize = 0;
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+    };
+
+    /**
+     * @brief Counters of the allocator installed by configureAllocator.
+     */
+    struct AllocatorStats
+    {
+        /** Bytes allocated by SQLite and not freed yet, rounded up to the block sizes */
+        uint64_t liveBytes = 0;
+        /**
+         * Highest value of liveBytes. Threads publish their balance every
+         * 64 KiB, so the peak may miss up to 64 KiB per thread.
+         */
+        uint64_t peakBytes = 0;
+        /** Per size class counters, from the smallest class to the large allocations */
+        std::vector<SizeClassStats> sizeClasses;
+    };
+
+    /**
+     * @brief Install the sqlpp allocator as the SQLite memory allocator (SQLITE_CONFIG_MALLOC)
+     *
+     * Allocations up to 32 KiB are served from power-of-two size classes.
+     * Each thread keeps a cache of free blocks per class and exchanges them
+     * in batches with a shared pool, so threads do not contend on the system
+     * allocator. Larger allocations go to malloc.
+     *
+     * SQLite only accepts a new allocator before it is initialized : call
+     * this at program start, before any connection is opened. The allocator
+     * cannot be removed afterwards.
+     * @param options Cache sizes
+     * @throw SQLiteException if SQLite is already initialized
+     */
+    void configureAllocator(const AllocatorOptions &options = AllocatorOptions());
+
+    /**
+     * @brief Check if configureAllocator has installed the allocator
+     * @return true if SQLite allocates through sqlpp
+     */
+    bool allocatorConfigured();
+
+    /**
+     * @brief Get the counters of the allocator
+     * @return AllocatorStats The counters, all zero if the allocator is not installed
+     */
+    AllocatorStats allocatorStats();
+}
+#endif	/* SQLITEALLOCATOR_H */
@@ -35,7 +35,7 @@ using namespace SQLPP;
 
 SQLiteException::SQLiteException(int errCode, const std::string &msg) : d(new _SQLiteExceptionData(msg))
 {
-    errCode = errCode;
+    d->errCode = errCode;
 }
 
 SQLiteException::SQLiteException(const SQLiteException& orig)
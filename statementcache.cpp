@@ -0,0 +1,162 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   StatementCache.cpp
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:12 AM
+ */
+
+#include "statementcache.h"
+#include "preparedstatement.h"
+#include <sqlite3.h>
+
+namespace SQLPP
+{
+    using locker = std::lock_guard<std::mutex>;
+
+    StatementCache::StatementCache()
+    {
+    }
+
+    StatementCache::~StatementCache()
+    {
+        clear();
+    }
+
+    void StatementCache::setCapacity(size_t capacity)
+    {
+        std::vector<StatementDataPtr> victims;
+        {
+            locker l(mutex);
+            maxSize = capacity;
+            evict(maxSize, victims);
+        }
+        for (const auto &data : victims) {
+            finalize(data);
+        }
+    }
+
+    size_t StatementCache::capacity() const
+    {
+        locker l(mutex);
+        return maxSize;
+    }
+
+    StatementCache::StatementDataPtr StatementCache::checkout(const std::string &sql)
+    {
+        locker l(mutex);
+        auto it = index.find(sql);
+        if (it == index.end()) {
+            counters.misses++;
+            return nullptr;
+        }
+        StatementDataPtr data = it->second->second;
+        lru.erase(it->second);
+        index.erase(it);
+        counters.hits++;
+        return data;
+    }
+
+    void StatementCache::checkin(const StatementDataPtr &data)
+    {
+        {
+            // The statement is idle, release its read transaction and bound values now
+            HandleLock statementLock(data->mutex);
+            sqlite3_reset(data->stmt);
+            data->clearBindings();
+            data->excecuted = false;
+            data->cursorClosed = true;
+        }
+
+        // Statements are finalized once the cache mutex is released, their lock
+        // may be held by a thread waiting for the cache
+        std::vector<StatementDataPtr> victims;
+        {
+            locker l(mutex);
+            if (maxSize == 0 || data->cacheGeneration != currentGeneration || index.count(data->sql) != 0) {
+                victims.push_back(data);
+            } else {
+                lru.emplace_front(data->sql, data);
+                index.emplace(data->sql, lru.begin());
+                evict(maxSize, victims);
+            }
+        }
+        for (const auto &victim : victims) {
+            finalize(victim);
+        }
+    }
+
+    void StatementCache::clear()
+    {
+        std::vector<StatementDataPtr> victims;
+        {
+            locker l(mutex);
+            currentGeneration++;
+            for (auto &entry : lru) {
+                victims.push_back(entry.second);
+            }
+            lru.clear();
+            index.clear();
+        }
+        for (const auto &data : victims) {
+            finalize(data);
+        }
+    }
+
+    uint64_t StatementCache::generation() const
+    {
+        locker l(mutex);
+        return currentGeneration;
+    }
+
+    StatementCacheStats StatementCache::stats() const
+    {
+        locker l(mutex);
+        StatementCacheStats result = counters;
+        result.size = lru.size();
+        result.capacity = maxSize;
+        return result;
+    }
+
+    void StatementCache::evict(size_t target, std::vector<StatementDataPtr> &victims)
+    {
+        while (lru.size() > target) {
+            Entry &entry = lru.back();
+            victims.push_back(entry.second);
+            index.erase(entry.first);
+            lru.pop_back();
+            counters.evictions++;
+        }
+    }
+
+    void StatementCache::finalize(const StatementDataPtr &data)
+    {
+        // Database::statementStats() may be reading the counters
+        HandleLock statementLock(data->mutex);
+        sqlite3_finalize(data->stmt);
+        data->stmt = nullptr;
+        data->prepared = false;
+        data->cached = false;
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   StatementCache.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 9:12 AM
+ */
+
+#ifndef STATEMENTCACHE_H
+#define	STATEMENTCACHE_H
+#include <stdint.h>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SQLPP
+{
+    class _PreparedStatementData;
+
+    /**
+     * @brief Counters describing the activity of a statement cache.
+     */
+    struct StatementCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    /**
+     * @brief LRU cache of idle prepared statements, keyed by SQL text.
+     *
+     * Only idle statements live in the cache : a statement leaves the cache
+     * when it is checked out and comes back when its last PreparedStatement
+     * handle is closed. Statements are reset and their bindings cleared when
+     * they come back, so a checked out statement is always ready to use.
+     */
+    class StatementCache
+    {
+    public:
+        using StatementDataPtr = std::shared_ptr<_PreparedStatementData>;
+
+        StatementCache();
+        StatementCache(const StatementCache& orig) = delete;
+        virtual ~StatementCache();
+
+        /**
+         * @brief Set the maximum number of idle statements
+         * @param capacity Maximum number of statements, 0 disables the cache
+         */
+        void setCapacity(size_t capacity);
+        /**
+         * @brief Get the maximum number of idle statements
+         * @return size_t The capacity
+         */
+        size_t capacity() const;
+        /**
+         * @brief Take an idle statement out of the cache
+         * @param sql The SQL text of the statement
+         * @return The statement data, or nullptr on a miss
+         */
+        StatementDataPtr checkout(const std::string &sql);
+        /**
+         * @brief Give a statement back to the cache
+         *
+         * The statement is finalized if the cache is disabled, if it was
+         * prepared before the last clear() or if an idle statement with the
+         * same SQL text is already cached.
+         * @param data The statement data
+         */
+        void checkin(const StatementDataPtr &data);
+        /**
+         * @brief Finalize all idle statements
+         *
+         * Statements checked out before the call are finalized when they come back.
+         */
+        void clear();
+        /**
+         * @brief Get the generation stamped on statements prepared for this cache
+         * @return uint64_t The current generation
+         */
+        uint64_t generation() const;
+        /**
+         * @brief Get the cache counters
+         * @return StatementCacheStats The counters
+         */
+        StatementCacheStats stats() const;
+
+    private:
+        using Entry = std::pair<std::string, StatementDataPtr>;
+
+        /* Move the least recently used entries beyond target to victims */
+        void evict(size_t target, std::vector<StatementDataPtr> &victims);
+        /* Takes the statement lock, call it without holding the cache mutex */
+        static void finalize(const StatementDataPtr &data);
+
+        /* Most recently used statement first */
+        std::list<Entry> lru;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        size_t maxSize = 0;
+        uint64_t currentGeneration = 0;
+        StatementCacheStats counters;
+        mutable std::mutex mutex;
+    };
+}
+#endif	/* STATEMENTCACHE_H */
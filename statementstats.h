@@ -0,0 +1,81 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   StatementStats.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 3:10 PM
+ */
+
+#ifndef STATEMENTSTATS_H
+#define	STATEMENTSTATS_H
+#include <stdint.h>
+
+namespace SQLPP
+{
+    /**
+     * @brief Runtime counters of a prepared statement.
+     *
+     * The first fields are the sqlite3_stmt_status counters. stepSeconds and
+     * timedSteps are only collected while timing is enabled on the statement
+     * (PreparedStatement::setTiming, Database::setStatementTiming), they cover
+     * the time spent stepping in Cursor::next(), Cursor::fetchBatch(),
+     * TypedQuery, executeUpdate() and executeMany().
+     */
+    struct StatementStats
+    {
+        /** SQLITE_STMTSTATUS_FULLSCAN_STEP : steps of full table scans */
+        uint64_t fullscanSteps = 0;
+        /** SQLITE_STMTSTATUS_SORT : sort operations */
+        uint64_t sorts = 0;
+        /** SQLITE_STMTSTATUS_AUTOINDEX : rows inserted into automatic indexes */
+        uint64_t autoIndexes = 0;
+        /** SQLITE_STMTSTATUS_VM_STEP : virtual machine operations */
+        uint64_t vmSteps = 0;
+        /** SQLITE_STMTSTATUS_REPREPARE : automatic re-preparations after schema changes */
+        uint64_t reprepares = 0;
+        /** SQLITE_STMTSTATUS_RUN : completed or reset runs */
+        uint64_t runs = 0;
+        /** SQLITE_STMTSTATUS_MEMUSED : bytes of heap used by the statement, never reset */
+        uint64_t memoryUsed = 0;
+        /** Number of timed sqlite3_step calls */
+        uint64_t timedSteps = 0;
+        /** Wall time of the timed sqlite3_step calls */
+        double stepSeconds = 0;
+
+        StatementStats & operator+=(const StatementStats &other)
+        {
+            fullscanSteps += other.fullscanSteps;
+            sorts += other.sorts;
+            autoIndexes += other.autoIndexes;
+            vmSteps += other.vmSteps;
+            reprepares += other.reprepares;
+            runs += other.runs;
+            memoryUsed += other.memoryUsed;
+            timedSteps += other.timedSteps;
+            stepSeconds += other.stepSeconds;
+            return *this;
+        }
+    };
+}
+#endif	/* STATEMENTSTATS_H */
@@ -0,0 +1,221 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   asyncquery_test.cpp
+ * Author: Morditux
+ *
+ * Created on October 19, 2026, 11:20 AM
+ */
+
+#include "asyncquery.h"
+#include "database.hpp"
+#include "sqliteexception.h"
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/* Coroutine layer of asyncquery.h, built as C++20 */
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+/* Fire and forget coroutine, finished tells when it returned */
+struct Task
+{
+    struct promise_type
+    {
+        std::promise<void> done;
+
+        Task get_return_object()
+        {
+            return Task{done.get_future()};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+            done.set_value();
+        }
+
+        void unhandled_exception()
+        {
+            done.set_exception(std::current_exception());
+        }
+    };
+
+    std::future<void> finished;
+};
+
+/* Event loop of the main thread, the scheduler posts to it */
+class Loop
+{
+public:
+    SQLPP::Scheduler scheduler()
+    {
+        return [this](std::function<void()> f) {
+            std::lock_guard<std::mutex> l(mutex);
+            queue.push_back(std::move(f));
+            ready.notify_one();
+        };
+    }
+
+    void run(std::future<void> &finished)
+    {
+        while (finished.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            std::function<void()> f;
+            {
+                std::unique_lock<std::mutex> l(mutex);
+                if (!ready.wait_for(l, std::chrono::milliseconds(10), [this]() { return !queue.empty(); })) {
+                    continue;
+                }
+                f = std::move(queue.front());
+                queue.pop_front();
+            }
+            f();
+        }
+        finished.get();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::function<void()> > queue;
+};
+
+typedef std::tuple<int64_t, std::string> Row;
+
+static Task queryAndStream(SQLPP::AsyncDatabase &adb, std::vector<Row> &all, std::vector<int64_t> &streamed)
+{
+    all = co_await adb.query<Row>("select id, name from items where id > ? order by id", 0);
+    auto rows = adb.rowsInBatches<std::tuple<int64_t> >(2, "select id from items order by id");
+    while (auto row = co_await rows.next()) {
+        streamed.push_back(std::get<0>(*row));
+    }
+}
+
+static Task failingQuery(SQLPP::AsyncDatabase &adb, bool &thrown)
+{
+    try {
+        co_await adb.query<Row>("select id, name from missing");
+    } catch (const SQLPP::SQLiteException &) {
+        thrown = true;
+    }
+}
+
+static Task dropStream(SQLPP::AsyncDatabase &adb, int64_t &first)
+{
+    auto rows = adb.rowsInBatches<std::tuple<int64_t> >(2, "select id from items order by id");
+    auto row = co_await rows.next();
+    first = row ? std::get<0>(*row) : -1;
+    // rows goes out of scope with its read transaction open
+}
+
+static void testQueries(SQLPP::Database &db, const SQLPP::Scheduler &scheduler, Loop *loop)
+{
+    SQLPP::AsyncDatabase adb(db, scheduler);
+    std::vector<Row> all;
+    std::vector<int64_t> streamed;
+    Task task = queryAndStream(adb, all, streamed);
+    if (loop) {
+        loop->run(task.finished);
+    } else {
+        task.finished.get();
+    }
+    CHECK(all.size() == 5);
+    if (all.size() == 5) {
+        CHECK(std::get<0>(all[0]) == 1);
+        CHECK(std::get<1>(all[4]) == "item 5");
+    }
+    CHECK(streamed == std::vector<int64_t>({1, 2, 3, 4, 5}));
+
+    bool thrown = false;
+    Task failing = failingQuery(adb, thrown);
+    if (loop) {
+        loop->run(failing.finished);
+    } else {
+        failing.finished.get();
+    }
+    CHECK(thrown);
+}
+
+static void testDroppedStream(SQLPP::Database &db, const char *fileName)
+{
+    SQLPP::AsyncDatabase adb(db);
+    int64_t first = 0;
+    dropStream(adb, first).finished.get();
+    CHECK(first == 1);
+    // The teardown is queued on the worker, wait for it
+    db.submit([](SQLPP::Database &) {
+        return 0;
+    }).get();
+    // No read transaction left : another connection can lock the file
+    SQLPP::Database other;
+    other.open(fileName);
+    other.exec("begin exclusive");
+    other.exec("commit");
+}
+
+int main()
+{
+    const char *fileName = "asyncquery_test.db";
+    std::remove(fileName);
+    try {
+        SQLPP::Database db;
+        db.open(fileName);
+        db.exec("create table items (id integer primary key, name text)");
+        for (int i = 1; i <= 5; i++) {
+            db.exec("insert into items (name) values ('item " + std::to_string(i) + "')");
+        }
+        // Resumed on the worker thread, then on the event loop of this thread
+        testQueries(db, SQLPP::Scheduler(), nullptr);
+        Loop loop;
+        testQueries(db, loop.scheduler(), &loop);
+        testDroppedStream(db, fileName);
+    } catch (const SQLPP::SQLiteException &e) {
+        std::fprintf(stderr, "Unexpected error: %s\n", e.what());
+        failures++;
+    }
+    std::remove(fileName);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   bulkloader_test.cpp
+ * Author: Morditux
+ *
+ * Created on October 18, 2026, 11:05 AM
+ */
+
+#include "bulkloader.h"
+#include "cursor.h"
+#include "database.hpp"
+#include "preparedstatement.h"
+#include "sqliteexception.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/* CSV parsing of BulkLoader, checked against the rows read back from the table */
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+static void writeFile(const char *fileName, const std::string &content)
+{
+    std::FILE *file = std::fopen(fileName, "wb");
+    std::fwrite(content.data(), 1, content.size(), file);
+    std::fclose(file);
+}
+
+/* Rows of the table as "a|b|c" strings, NULL as \N */
+static std::vector<std::string> readRows(SQLPP::Database &db, const std::string &table)
+{
+    std::vector<std::string> rows;
+    SQLPP::PreparedStatement info = db.prepareStatement("select name from pragma_table_info(?)");
+    info.setString(1, table);
+    SQLPP::Cursor names = info.execute();
+    std::string sql;
+    while (names.next()) {
+        sql += (sql.empty() ? "select " : ", ") + ("ifnull(" + names.getAsString(0) + ", '\\N')");
+    }
+    SQLPP::PreparedStatement select = db.prepareStatement(sql + " from " + table + " order by rowid");
+    SQLPP::Cursor cursor = select.execute();
+    int columns = cursor.columnCount();
+    while (cursor.next()) {
+        std::string row;
+        for (int i = 0; i < columns; i++) {
+            row += i > 0 ? "|" : "";
+            row += cursor.getAsString(i);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+static void testQuoting(SQLPP::Database &db)
+{
+    db.exec("create table quoting (id integer, name text, note text)");
+    writeFile("bulkloader_quoting.csv",
+              "id,name,note\r\n"
+              "1,\"say \"\"hi\"\"\",plain\r\n"
+              "2,\"two\nlines\",\"a,b\"\r\n"
+              "3,,\"\"\r\n"
+              "4,\"\"\"\",\"crlf\r\ninside\"\r\n");
+    SQLPP::BulkLoader loader(&db);
+    SQLPP::BulkLoadResult result = loader.load("bulkloader_quoting.csv", "quoting");
+    CHECK(result.completed);
+    CHECK(result.rows == 4);
+    std::vector<std::string> rows = readRows(db, "quoting");
+    CHECK(rows.size() == 4);
+    if (rows.size() == 4) {
+        CHECK(rows[0] == "1|say \"hi\"|plain");
+        CHECK(rows[1] == "2|two\nlines|a,b");
+        // Empty unquoted field is NULL, empty quoted field is an empty string
+        CHECK(rows[2] == "3|\\N|");
+        CHECK(rows[3] == "4|\"|crlf\r\ninside");
+    }
+    std::remove("bulkloader_quoting.csv");
+}
+
+static void testChunkBoundaries(SQLPP::Database &db)
+{
+    db.exec("create table chunks (id integer, text text, value real)");
+    std::string content = "id,text,value\n";
+    std::vector<std::string> expected;
+    for (int i = 0; i < 3000; i++) {
+        // Quoted fields with delimiters, quotes and line breaks land on every chunk boundary
+        std::string text = "row " + std::to_string(i);
+        if (i % 3 == 0) {
+            text += ",\n\"quoted\"\r\nend";
+        }
+        std::string quoted = "\"";
+        for (char c : text) {
+            quoted += c == '"' ? "\"\"" : std::string(1, c);
+        }
+        quoted += "\"";
+        content += std::to_string(i) + "," + quoted + "," + std::to_string(i) + ".5" + (i % 2 ? "\r\n" : "\n");
+        expected.push_back(std::to_string(i) + "|" + text + "|" + std::to_string(i) + ".5");
+    }
+    writeFile("bulkloader_chunks.csv", content);
+    SQLPP::BulkLoadOptions options;
+    options.chunkBytes = 4096;
+    options.parserThreads = 3;
+    options.rowsPerTransaction = 500;
+    SQLPP::BulkLoader loader(&db);
+    SQLPP::BulkLoadResult result = loader.load("bulkloader_chunks.csv", "chunks", options);
+    CHECK(result.completed);
+    CHECK(result.rows == 3000);
+    CHECK(readRows(db, "chunks") == expected);
+    std::remove("bulkloader_chunks.csv");
+}
+
+static void testNoHeader(SQLPP::Database &db)
+{
+    db.exec("create table short (a integer, b integer, c integer)");
+    // Leading blank lines, then a record shorter than the table
+    writeFile("bulkloader_short.csv", "\n\r\n1,2\n3,4,5\n");
+    SQLPP::BulkLoadOptions options;
+    options.header = false;
+    SQLPP::BulkLoader loader(&db);
+    CHECK(loader.load("bulkloader_short.csv", "short", options).rows == 2);
+    std::vector<std::string> rows = readRows(db, "short");
+    CHECK(rows.size() == 2);
+    if (rows.size() == 2) {
+        CHECK(rows[0] == "1|2|\\N");
+        CHECK(rows[1] == "3|4|5");
+    }
+
+    // Too many fields is an error
+    writeFile("bulkloader_short.csv", "1,2,3,4\n");
+    try {
+        loader.load("bulkloader_short.csv", "short", options);
+        CHECK(false);
+    } catch (const SQLPP::SQLiteException &) {
+    }
+
+    db.exec("create table blank (id integer, name text)");
+    writeFile("bulkloader_short.csv", "\r\n\nid,name\n1,x\n");
+    CHECK(loader.load("bulkloader_short.csv", "blank").rows == 1);
+    CHECK(readRows(db, "blank") == std::vector<std::string>(1, "1|x"));
+    std::remove("bulkloader_short.csv");
+}
+
+static void testAffinity(SQLPP::Database &db)
+{
+    db.exec("create table affinity (code text, raw, amount integer, price real)");
+    writeFile("bulkloader_affinity.csv", "code,raw,amount,price\n007,1.50,007,1.50\n");
+    SQLPP::BulkLoader loader(&db);
+    CHECK(loader.load("bulkloader_affinity.csv", "affinity").rows == 1);
+    // TEXT and untyped columns keep the field as written, numeric columns convert it
+    SQLPP::PreparedStatement select = db.prepareStatement(
+        "select code, typeof(code), raw, typeof(raw), amount, typeof(amount), price, typeof(price) from affinity");
+    SQLPP::Cursor cursor = select.execute();
+    CHECK(cursor.next());
+    CHECK(cursor.getAsString(0) == "007");
+    CHECK(cursor.getAsString(1) == "text");
+    CHECK(cursor.getAsString(2) == "1.50");
+    CHECK(cursor.getAsString(3) == "text");
+    CHECK(cursor.getAsLong(4) == 7);
+    CHECK(cursor.getAsString(5) == "integer");
+    CHECK(cursor.getAsDouble(6) == 1.5);
+    CHECK(cursor.getAsString(7) == "real");
+    std::remove("bulkloader_affinity.csv");
+}
+
+int main()
+{
+    try {
+        SQLPP::Database db;
+        db.open(":memory:");
+        testQuoting(db);
+        testChunkBoundaries(db);
+        testNoHeader(db);
+        testAffinity(db);
+    } catch (const SQLPP::SQLiteException &e) {
+        std::fprintf(stderr, "Unexpected error: %s\n", e.what());
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   columnarfile_test.cpp
+ * Author: Morditux
+ *
+ * Created on October 18, 2026, 10:15 AM
+ */
+
+#include "columnarfile.h"
+#include "cursor.h"
+#include "blob.h"
+#include "database.hpp"
+#include "preparedstatement.h"
+#include "sqliteexception.h"
+#include <cstdio>
+#include <string>
+
+/* Round trip of query results through ColumnarWriter and ColumnarReader */
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+static std::string text(const SQLPP::ColumnView &view)
+{
+    return std::string(view.data, view.size);
+}
+
+static void testRoundTrip(SQLPP::Database &db)
+{
+    const int rows = 1050;
+    const size_t rowsPerGroup = 100;
+    SQLPP::ColumnarOptions options;
+    options.rowsPerGroup = rowsPerGroup;
+    SQLPP::PreparedStatement select = db.prepareStatement("select id, score, category, label, data from items order by id");
+    SQLPP::Cursor cursor = select.execute();
+    CHECK(SQLPP::ColumnarWriter().write(cursor, "columnarfile_test.col", options) == rows);
+
+    SQLPP::ColumnarReader reader;
+    reader.open("columnarfile_test.col");
+    CHECK(reader.rowCount() == rows);
+    CHECK(reader.columnCount() == 5);
+    CHECK(reader.groupCount() == 11);
+    CHECK(reader.columnIndex("category") == 2);
+    CHECK(reader.columnType(0) == SQLPP::ColumnType::Int64);
+    CHECK(reader.columnType(1) == SQLPP::ColumnType::Double);
+    CHECK(reader.columnType(2) == SQLPP::ColumnType::Text);
+    CHECK(reader.columnType(4) == SQLPP::ColumnType::Blob);
+
+    int row = 0;
+    for (size_t group = 0; group < reader.groupCount(); group++) {
+        const SQLPP::ColumnarChunk &ids = reader.chunk(group, 0);
+        const SQLPP::ColumnarChunk &scores = reader.chunk(group, 1);
+        const SQLPP::ColumnarChunk &categories = reader.chunk(group, 2);
+        const SQLPP::ColumnarChunk &labels = reader.chunk(group, 3);
+        const SQLPP::ColumnarChunk &data = reader.chunk(group, 4);
+        CHECK(ids.size() == (group < 10 ? rowsPerGroup : 50));
+        // Few distinct categories, one label per row
+        CHECK(categories.isDictionary());
+        CHECK(!labels.isDictionary());
+        CHECK(categories.codes().size() == categories.size());
+        for (size_t i = 0; i < ids.size(); i++, row++) {
+            CHECK(!ids.isNull(i) && ids.ints()[i] == row);
+            CHECK(scores.isNull(i) == (row % 5 == 0));
+            if (row % 5 != 0) {
+                CHECK(scores.doubles()[i] == row * 0.5);
+            }
+            CHECK(categories.isNull(i) == (row % 7 == 0));
+            CHECK(text(categories.value(i)) == (row % 7 == 0 ? "" : "category" + std::to_string(row % 3)));
+            CHECK(labels.isNull(i) == (row % 4 == 0));
+            CHECK(text(labels.value(i)) == (row % 4 == 0 ? "" : "label" + std::to_string(row)));
+            CHECK(data.isNull(i) == (row % 6 == 0));
+            CHECK(text(data.value(i)) == (row % 6 == 0 ? "" : std::string(row % 10, static_cast<char> (row))));
+        }
+    }
+    CHECK(row == rows);
+    CHECK(reader.chunk(10, 1).nullCount() == 10);
+    std::remove("columnarfile_test.col");
+}
+
+static void testEmptyResult(SQLPP::Database &db)
+{
+    SQLPP::PreparedStatement select = db.prepareStatement("select id, label from items where id < 0");
+    SQLPP::Cursor cursor = select.execute();
+    CHECK(SQLPP::ColumnarWriter().write(cursor, "columnarfile_empty.col") == 0);
+
+    SQLPP::ColumnarReader reader;
+    reader.open("columnarfile_empty.col");
+    CHECK(reader.rowCount() == 0);
+    CHECK(reader.columnCount() == 2);
+    CHECK(reader.groupCount() == 0);
+    CHECK(reader.columnName(1) == "label");
+    std::remove("columnarfile_empty.col");
+}
+
+static void testInvalidFile()
+{
+    std::FILE *file = std::fopen("columnarfile_invalid.col", "wb");
+    std::fputs("SQLPPCOL but not a columnar file at all", file);
+    std::fclose(file);
+    SQLPP::ColumnarReader reader;
+    try {
+        reader.open("columnarfile_invalid.col");
+        CHECK(false);
+    } catch (const SQLPP::SQLiteException &e) {
+        CHECK(e.errorCode() == SQLITE_CORRUPT);
+    }
+    std::remove("columnarfile_invalid.col");
+}
+
+int main()
+{
+    try {
+        SQLPP::Database db;
+        db.open(":memory:");
+        db.exec("create table items (id INTEGER, score REAL, category TEXT, label TEXT, data BLOB)");
+        SQLPP::PreparedStatement insert = db.prepareStatement("insert into items values (?, ?, ?, ?, ?)");
+        db.begin();
+        for (int i = 0; i < 1050; i++) {
+            // Parameters left unbound are NULL
+            insert.clearBindings();
+            insert.setLong(1, i);
+            if (i % 5 != 0) {
+                insert.setDouble(2, i * 0.5);
+            }
+            if (i % 7 != 0) {
+                insert.setString(3, "category" + std::to_string(i % 3));
+            }
+            if (i % 4 != 0) {
+                insert.setString(4, "label" + std::to_string(i));
+            }
+            std::string bytes(i % 10, static_cast<char> (i));
+            SQLPP::Blob blob(bytes.size(), bytes.data());
+            if (i % 6 != 0) {
+                insert.setBlob(5, blob);
+            }
+            insert.executeUpdate();
+        }
+        db.commit();
+        testRoundTrip(db);
+        testEmptyResult(db);
+        testInvalidFile();
+    } catch (const SQLPP::SQLiteException &e) {
+        std::fprintf(stderr, "Unexpected error: %s\n", e.what());
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   tuplebinder_test.cpp
+ * Author: Morditux
+ *
+ * Created on October 19, 2026, 9:40 AM
+ */
+
+#include "cursor.h"
+#include "database.hpp"
+#include "preparedstatement.h"
+#include "sqliteexception.h"
+#include "typedquery.h"
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/* Values bound through _TupleBinder by executeMany, executeAsync and TypedQuery */
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+static int64_t readValue(SQLPP::Database &db, int64_t id)
+{
+    SQLPP::PreparedStatement select = db.prepareStatement("select value from numbers where id = ?");
+    select.setLong(1, id);
+    SQLPP::Cursor cursor = select.execute();
+    return cursor.next() ? cursor.getAsLong(0) : -1;
+}
+
+static void testExecuteMany(SQLPP::Database &db)
+{
+    std::vector<std::tuple<int, uint32_t> > rows;
+    rows.push_back(std::make_tuple(1, static_cast<uint32_t> (4000000000u)));
+    rows.push_back(std::make_tuple(2, std::numeric_limits<uint32_t>::max()));
+    SQLPP::PreparedStatement insert = db.prepareStatement("insert into numbers (id, value) values (?, ?)");
+    insert.executeMany(rows);
+    CHECK(readValue(db, 1) == 4000000000LL);
+    CHECK(readValue(db, 2) == 4294967295LL);
+}
+
+static void testExecuteAsync(SQLPP::Database &db)
+{
+    uint32_t value = 3000000000u;
+    unsigned short small = 65535;
+    CHECK(db.executeAsync("insert into numbers (id, value) values (?, ?)", 3, value).get() == 1);
+    CHECK(db.executeAsync("insert into numbers (id, value) values (?, ?)", 4, small).get() == 1);
+    CHECK(readValue(db, 3) == 3000000000LL);
+    CHECK(readValue(db, 4) == 65535);
+}
+
+static void testTypedQuery(SQLPP::Database &db)
+{
+    SQLPP::TypedQuery<std::tuple<int64_t> > query(&db, "select id from numbers where value = ?");
+    query.bind(static_cast<uint32_t> (4000000000u));
+    std::vector<std::tuple<int64_t> > rows = query.fetchAll();
+    CHECK(rows.size() == 1);
+    if (rows.size() == 1) {
+        CHECK(std::get<0>(rows[0]) == 1);
+    }
+    query.bind(-1);
+    CHECK(query.fetchAll().empty());
+}
+
+int main()
+{
+    try {
+        SQLPP::Database db;
+        db.open(":memory:");
+        db.exec("create table numbers (id integer primary key, value integer)");
+        testExecuteMany(db);
+        testExecuteAsync(db);
+        testTypedQuery(db);
+    } catch (const SQLPP::SQLiteException &e) {
+        std::fprintf(stderr, "Unexpected error: %s\n", e.what());
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
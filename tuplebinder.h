@@ -0,0 +1,117 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   TupleBinder.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 3:40 PM
+ */
+
+#ifndef TUPLEBINDER_H
+#define	TUPLEBINDER_H
+#include "blob.h"
+#include <sqlite3.h>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace SQLPP
+{
+    /*
+     * Binds the members of a tuple to the parameters 1..N of a statement.
+     * Strings and Blobs are bound with lifetime : SQLITE_STATIC when the
+     * tuple outlives the step, SQLITE_TRANSIENT (SQLite copies) otherwise.
+     */
+    class _TupleBinder
+    {
+    public:
+        template <typename Tuple>
+        static void bind(sqlite3_stmt *stmt, const Tuple &row, sqlite3_destructor_type lifetime = SQLITE_STATIC)
+        {
+            bindFrom<0>(stmt, row, lifetime, std::integral_constant<bool, (std::tuple_size<Tuple>::value > 0)>());
+        }
+
+    private:
+        template <size_t I, typename Tuple>
+        static void bindFrom(sqlite3_stmt *stmt, const Tuple &row, sqlite3_destructor_type lifetime, std::true_type)
+        {
+            bindValue(stmt, static_cast<int> (I + 1), std::get<I>(row), lifetime);
+            bindFrom<I + 1>(stmt, row, lifetime, std::integral_constant<bool, (I + 1 < std::tuple_size<Tuple>::value)>());
+        }
+
+        template <size_t I, typename Tuple>
+        static void bindFrom(sqlite3_stmt *, const Tuple &, sqlite3_destructor_type, std::false_type)
+        {
+        }
+
+        /* Integral types whose every value fits in an int, unsigned int does not */
+        template <typename T>
+        struct _FitsInt : std::integral_constant<bool, std::is_integral<T>::value
+        && (sizeof (T) < sizeof (int) || (sizeof (T) == sizeof (int) && std::is_signed<T>::value))>
+        {
+        };
+
+        template <typename T>
+        static typename std::enable_if<_FitsInt<T>::value>::type
+        bindValue(sqlite3_stmt *stmt, int index, T value, sqlite3_destructor_type)
+        {
+            sqlite3_bind_int(stmt, index, static_cast<int> (value));
+        }
+
+        template <typename T>
+        static typename std::enable_if<std::is_integral<T>::value && !_FitsInt<T>::value>::type
+        bindValue(sqlite3_stmt *stmt, int index, T value, sqlite3_destructor_type)
+        {
+            sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64> (value));
+        }
+
+        template <typename T>
+        static typename std::enable_if<std::is_floating_point<T>::value>::type
+        bindValue(sqlite3_stmt *stmt, int index, T value, sqlite3_destructor_type)
+        {
+            sqlite3_bind_double(stmt, index, static_cast<double> (value));
+        }
+
+        static void bindValue(sqlite3_stmt *stmt, int index, const std::string &value, sqlite3_destructor_type lifetime)
+        {
+            sqlite3_bind_text(stmt, index, value.c_str(), value.size(), lifetime);
+        }
+
+        static void bindValue(sqlite3_stmt *stmt, int index, const char *value, sqlite3_destructor_type lifetime)
+        {
+            sqlite3_bind_text(stmt, index, value, -1, lifetime);
+        }
+
+        static void bindValue(sqlite3_stmt *stmt, int index, const Blob &value, sqlite3_destructor_type lifetime)
+        {
+            sqlite3_bind_blob(stmt, index, value.data(), value.size(), lifetime);
+        }
+
+        static void bindValue(sqlite3_stmt *stmt, int index, std::nullptr_t, sqlite3_destructor_type)
+        {
+            sqlite3_bind_null(stmt, index);
+        }
+    };
+}
+#endif	/* TUPLEBINDER_H */
@@ -0,0 +1,257 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2014-2015 Morditux
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * File:   TypedQuery.h
+ * Author: Morditux
+ *
+ * Created on October 17, 2026, 2:10 PM
+ */
+
+#ifndef TYPEDQUERY_H
+#define	TYPEDQUERY_H
+#include "blob.h"
+#include "columnreader.h"
+#include "database.hpp"
+#include "preparedstatement.h"
+#include "sqliteexception.h"
+#include "tuplebinder.h"
+#include <sqlite3.h>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace SQLPP
+{
+    /* Decodes columns I..N-1 of the current row into a tuple */
+    template <size_t I, size_t N>
+    struct _RowDecoder
+    {
+        template <typename Tuple>
+        static void decode(sqlite3_stmt *stmt, Tuple &row)
+        {
+            typedef typename std::tuple_element<I, Tuple>::type Type;
+            std::get<I>(row) = _ColumnReader<Type>::read(stmt, static_cast<int> (I));
+            _RowDecoder<I + 1, N>::decode(stmt, row);
+        }
+    };
+
+    template <size_t N>
+    struct _RowDecoder<N, N>
+    {
+        template <typename Tuple>
+        static void decode(sqlite3_stmt *, Tuple &)
+        {
+        }
+    };
+
+    template <typename Row>
+    class TypedQuery;
+
+    /**
+     * @brief A query whose rows are decoded into a std::tuple at compile time.
+     *
+     * The column count is checked against the tuple when the query is
+     * prepared, then column i is read into tuple member i with the matching
+     * sqlite3_column_* call : no name lookup, no per-cell check and one lock
+     * per row. Supported members are integers, floating point, std::string,
+     * Blob and std::vector<char>. Parameters are bound with bind() or through statement().
+     *
+     * @code
+     * SQLPP::TypedQuery<std::tuple<int64_t, std::string, double> > q(&db, "select id, name, score from users");
+     * for (const auto &row : q) { ... }
+     * @endcode
+     */
+    template <typename... Types>
+    class TypedQuery<std::tuple<Types...> >
+    {
+    public:
+        typedef std::tuple<Types...> Row;
+
+        /**
+         * @brief Input iterator over the rows of the query
+         */
+        class iterator
+        {
+            friend TypedQuery;
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef Row value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Row * pointer;
+            typedef const Row & reference;
+
+            iterator() : query(nullptr)
+            {
+            }
+
+            const Row & operator*() const
+            {
+                return row;
+            }
+
+            const Row * operator->() const
+            {
+                return &row;
+            }
+
+            iterator & operator++()
+            {
+                if (!query->step(row)) {
+                    query = nullptr;
+                    busy.reset();
+                }
+                return *this;
+            }
+
+            bool operator==(const iterator &other) const
+            {
+                return query == other.query;
+            }
+
+            bool operator!=(const iterator &other) const
+            {
+                return query != other.query;
+            }
+
+        private:
+            iterator(TypedQuery *query, const std::shared_ptr<void> &busy) : query(query), busy(busy)
+            {
+                ++(*this);
+            }
+
+            TypedQuery *query;
+            Row row;
+            /* Shared by the copies, the last one marks the statement free again */
+            std::shared_ptr<void> busy;
+        };
+
+        /**
+         * @brief Prepare the query through Database::prepareStatement
+         * @param db Pointer to the Database object
+         * @param sql The SQL query string
+         * @throw SQLiteException on error or if the column count does not match the tuple
+         */
+        TypedQuery(Database *db, const std::string &sql) : stmt(db->prepareStatement(sql))
+        {
+            int count = sqlite3_column_count(stmt.d->stmt);
+            if (count != static_cast<int> (sizeof...(Types))) {
+                throw SQLiteException(-1, "TypedQuery - Query returns " + std::to_string(count)
+                                      + " columns, the row type has " + std::to_string(sizeof...(Types)));
+            }
+        }
+
+        /**
+         * @brief Get the underlying statement, e.g. to bind parameters
+         * @return PreparedStatement& The statement
+         */
+        PreparedStatement & statement()
+        {
+            return stmt;
+        }
+
+        /**
+         * @brief Bind values to the parameters 1..N of the query
+         *
+         * Strings and Blobs are bound without copy, they must stay alive
+         * until the query has been run.
+         * @param values Integers, floating point, std::string, const char *, Blob or nullptr
+         */
+        template <typename... Values>
+        void bind(const Values &... values)
+        {
+            HandleLock l(stmt.d->mutex);
+            _TupleBinder::bind(stmt.d->stmt, std::tie(values...));
+        }
+
+        /**
+         * @brief Run the query from its first row
+         *
+         * Until the iteration reaches the end or its last iterator is
+         * destroyed, the statement is busy as with an open Cursor.
+         * @return iterator on the first row
+         * @throw SQLiteException on error or if the statement is already running
+         */
+        iterator begin()
+        {
+            HandleLock l(stmt.d->mutex);
+            if (!stmt.d->cursorClosed) {
+                throw SQLiteException(-1, "Current Cursor must be closed before executing prepared statement");
+            }
+            sqlite3_reset(stmt.d->stmt);
+            // Like a Cursor, the iteration keeps execute() and other iterations out
+            stmt.d->cursorClosed = false;
+            std::shared_ptr<_PreparedStatementData> data = stmt.d;
+            std::shared_ptr<void> busy(data.get(), [data](void *) {
+                HandleLock l(data->mutex);
+                sqlite3_reset(data->stmt);
+                data->cursorClosed = true;
+            });
+            return iterator(this, busy);
+        }
+
+        iterator end()
+        {
+            return iterator();
+        }
+
+        /**
+         * @brief Run the query and collect all its rows
+         * @return std::vector<Row> The rows
+         * @throw SQLiteException on error
+         */
+        std::vector<Row> fetchAll()
+        {
+            std::vector<Row> rows;
+            for (iterator it = begin(); it != end(); ++it) {
+                rows.push_back(*it);
+            }
+            return rows;
+        }
+
+    private:
+        bool step(Row &row)
+        {
+            HandleLock l(stmt.d->mutex);
+            int result = PreparedStatement::step(*stmt.d);
+            if (result == SQLITE_ROW) {
+                _RowDecoder<0, sizeof...(Types)>::decode(stmt.d->stmt, row);
+                return true;
+            }
+            if (result != SQLITE_DONE) {
+                std::string msg = stmt.errorMsg();
+                sqlite3_reset(stmt.d->stmt);
+                throw SQLiteException(result, msg);
+            }
+            // Done, release the read transaction
+            sqlite3_reset(stmt.d->stmt);
+            return false;
+        }
+
+        PreparedStatement stmt;
+    };
+}
+#endif	/* TYPEDQUERY_H */